@@ -96,6 +96,9 @@ namespace Oxygen
 
 			// Fastmath
 			conf.Options.Add(Options.Vc.Compiler.FloatingPointModel.Fast);
+			// Deterministic math for lockstep and replays, instead of Fastmath:
+			//conf.Options.Add(Options.Vc.Compiler.FloatingPointModel.Precise);
+			//conf.Defines.Add("OXYMATHDETERMINISTIC");
 
 			// Link dx11
 			conf.LibraryFiles.Add("d3d11.lib");
@@ -13,6 +13,7 @@ namespace oxygen
 		m_projectionMatrix = Math::Perspective(m_vfov, 16.0f / 9.0f,
 													m_nearPlane, m_farPlane);
 		m_viewProjectionMatrix = m_viewMatrix * m_projectionMatrix;
+		m_frustum = oxyFrustum::FromViewProjection(m_viewProjectionMatrix);
 	}
 
 }; // namespace oxygen
\ No newline at end of file
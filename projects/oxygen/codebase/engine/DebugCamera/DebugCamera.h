@@ -15,6 +15,8 @@ namespace oxygen
 		oxyMat4x4 m_viewMatrix{};
 		oxyMat4x4 m_projectionMatrix{};
 		oxyMat4x4 m_viewProjectionMatrix{};
+		// World space planes of m_viewProjectionMatrix
+		oxyFrustum m_frustum{};
 
 		auto ComputeMatrices() -> void;
 	};
@@ -2,6 +2,81 @@
 
 namespace oxygen
 {
+	/**
+	 * @brief Returned by EventManager::RegisterListener, identifies one
+	 * registration so it can be removed in constant time. The generation
+	 * guards against stale handles after the slot has been reused.
+	 */
+	struct EventListenerHandle
+	{
+		oxyU32 m_index{};
+		oxyU32 m_generation{};
+
+		auto IsValid() const -> oxyBool
+		{
+			return m_generation != 0;
+		}
+	};
+
+	/**
+	 * @brief Event type defined outside of the EventType enum, see
+	 * DECLARE_RUNTIME_EVENT_TYPE.
+	 */
+	struct RuntimeEventTypeDescription
+	{
+		oxyU64 m_id{};
+		const char* m_name{};
+	};
+
+	/**
+	 * @brief Runtime event types, the entry at index i has the EventType value
+	 * EventType_Count + i.
+	 */
+	inline auto GetRuntimeEventTypes()
+		-> std::vector<RuntimeEventTypeDescription>&
+	{
+		static std::vector<RuntimeEventTypeDescription> types{};
+		return types;
+	}
+
+	/**
+	 * @brief Maps a CRC64 type id to a dense EventType value past
+	 * EventType_Count. Registering the same id again returns the same value.
+	 */
+	inline auto RegisterRuntimeEventType(oxyU64 id, const char* name)
+		-> EventType
+	{
+		auto& types = GetRuntimeEventTypes();
+		for (oxySize i = 0; i < types.size(); ++i)
+		{
+			if (types[i].m_id == id)
+			{
+				// Two different names hashing to the same id
+				OXYCHECK(std::string_view{types[i].m_name} == name);
+				return static_cast<EventType>(EventType_Count + i);
+			}
+		}
+		OXYCHECK(EventType_Count + types.size() <
+				 std::numeric_limits<std::underlying_type_t<EventType>>::max());
+		types.push_back({id, name});
+		return static_cast<EventType>(EventType_Count + types.size() - 1);
+	}
+
+	/**
+	 * @brief Looks up a runtime event type by id, returns EventType_Invalid if
+	 * it has not been registered.
+	 */
+	inline auto FindRuntimeEventType(oxyU64 id) -> EventType
+	{
+		const auto& types = GetRuntimeEventTypes();
+		for (oxySize i = 0; i < types.size(); ++i)
+		{
+			if (types[i].m_id == id)
+				return static_cast<EventType>(EventType_Count + i);
+		}
+		return EventType_Invalid;
+	}
+
 	/**
 	 * @brief Base class for all events.
 	 * 	 
@@ -10,8 +85,26 @@ namespace oxygen
 	*/
 	struct Event
 	{
+		static inline constexpr oxyU32 k_noKey{~0U};
+
 		virtual ~Event() = default;
 		virtual auto GetType() const -> EventType = 0;
+		/**
+		 * @brief Key matched against keyed listeners, see
+		 * DECLARE_EVENT_KEY.
+		 */
+		virtual auto GetKey() const -> oxyU32
+		{
+			return k_noKey;
+		}
+		/**
+		 * @brief Second key dispatched after GetKey(), for events that can
+		 * also be listened to as a group, see DECLARE_EVENT_GROUP_KEY.
+		 */
+		virtual auto GetGroupKey() const -> oxyU32
+		{
+			return k_noKey;
+		}
 		virtual auto GetPriority() const -> EventPriority
 		{
 			return EventPriority_Low;
@@ -44,27 +137,82 @@ namespace oxygen
 	{                                                                          \
 		return GetStaticTypeStr();                                             \
 	}
+/**
+ * @brief Declares an event type that is not part of the EventType enum, so it
+ * can live outside of the engine core. The type is identified by the CRC64 of
+ * its name and gets a dense EventType value on first use, dispatch then
+ * indexes arrays exactly like built-in events.
+ */
+#define DECLARE_RUNTIME_EVENT_TYPE(SelfType)                                   \
+	static inline auto GetStaticType()->EventType                              \
+	{                                                                          \
+		static const EventType type = RegisterRuntimeEventType(                \
+			::oxygen::operator""_sid<#SelfType>().GetID(), #SelfType);         \
+		return type;                                                           \
+	}                                                                          \
+	static inline auto GetStaticTypeStr()->const char*                         \
+	{                                                                          \
+		return #SelfType;                                                      \
+	}                                                                          \
+	auto GetType() const->EventType override                                   \
+	{                                                                          \
+		return GetStaticType();                                                \
+	}                                                                          \
+	auto GetTypeStr() const->const char* override                              \
+	{                                                                          \
+		return GetStaticTypeStr();                                             \
+	}
+/**
+ * @brief Exposes a member as the event's filter key, listeners registered with
+ * a key are only invoked for events with a matching key.
+ */
+#define DECLARE_EVENT_KEY(Member)                                              \
+	auto GetKey() const->oxyU32 override                                       \
+	{                                                                          \
+		return static_cast<oxyU32>(Member);                                    \
+	}
+/**
+ * @brief Exposes a second filter key, listeners registered with either key
+ * are invoked. Group keys must not overlap the values of DECLARE_EVENT_KEY.
+ */
+#define DECLARE_EVENT_GROUP_KEY(Member)                                        \
+	auto GetGroupKey() const->oxyU32 override                                  \
+	{                                                                          \
+		return static_cast<oxyU32>(Member);                                    \
+	}
 #define DECLARE_EVENT_PRIORITY(Priority)                                       \
 	auto GetPriority() const->EventPriority override                           \
 	{                                                                          \
 		return EventPriority_##Priority;                                       \
 	}
 
-	struct KeyboardButtonStateChangedEvent : Event
+	/**
+	 * @brief Base for events raised by InputManager.
+	 */
+	struct InputEvent : Event
+	{
+		// GetHighPrecisionTime() when the input reached the platform layer,
+		// see InputLatencyTracker.
+		oxyU64 m_captureTime{};
+	};
+
+	struct KeyboardButtonStateChangedEvent : InputEvent
 	{
 		DECLARE_EVENT_TYPE(KeyboardButtonStateChangedEvent);
+		DECLARE_EVENT_KEY(m_button);
 		KeyboardButton m_button{};
 		oxyBool m_isDown{};
 	};
 
-	struct MouseButtonStateChangedEvent : Event
+	struct MouseButtonStateChangedEvent : InputEvent
 	{
 		DECLARE_EVENT_TYPE(MouseButtonStateChangedEvent);
+		DECLARE_EVENT_KEY(m_button);
 		MouseButton m_button{};
 		oxyBool m_isDown{};
 	};
 
-	struct MouseMovedEvent : Event
+	struct MouseMovedEvent : InputEvent
 	{
 		DECLARE_EVENT_TYPE(MouseMovedEvent);
 		oxyS32 m_x{};
@@ -75,30 +223,94 @@ namespace oxygen
 		oxyF32 m_dy{};
 	};
 
-	struct ControllerConnectionStateChangedEvent : Event
+	/**
+	 * @brief Keyed on the bare controller index.
+	 */
+	struct ControllerConnectionStateChangedEvent : InputEvent
 	{
 		DECLARE_EVENT_TYPE(ControllerConnectionStateChangedEvent);
+		DECLARE_EVENT_KEY(m_controllerIndex);
 		oxyS32 m_controllerIndex{};
 		oxyBool m_isConnected{};
 	};
 
-	struct ControllerAxisValueChangedEvent : Event
+	/**
+	 * @brief Key of one controller's axis, see ControllerAxisValueChangedEvent.
+	 */
+	constexpr auto GetControllerAxisEventKey(oxyS32 controllerIndex,
+											 ControllerAxis axis) -> oxyU32
+	{
+		return static_cast<oxyU32>(controllerIndex) * ControllerAxis_Count +
+			   axis;
+	}
+	/**
+	 * @brief Key of one controller's button, see
+	 * ControllerButtonStateChangedEvent.
+	 */
+	constexpr auto GetControllerButtonEventKey(oxyS32 controllerIndex,
+											   ControllerButton button)
+		-> oxyU32
+	{
+		return static_cast<oxyU32>(controllerIndex) * ControllerButton_Count +
+			   button;
+	}
+	/**
+	 * @brief First key of GetControllerEventKey, past every axis and button
+	 * key so both can be listened to on the same event type.
+	 */
+	inline constexpr oxyU32 k_controllerKeyBase{
+		OXYGENMAXCONTROLLERS *
+		std::max<oxyU32>(ControllerAxis_Count, ControllerButton_Count)};
+	/**
+	 * @brief Key of every axis or every button of one controller, see
+	 * ControllerAxisValueChangedEvent and ControllerButtonStateChangedEvent.
+	 */
+	constexpr auto GetControllerEventKey(oxyS32 controllerIndex) -> oxyU32
+	{
+		return k_controllerKeyBase + static_cast<oxyU32>(controllerIndex);
+	}
+
+	/**
+	 * @brief Keyed on controller and axis, GetControllerAxisEventKey, and on
+	 * the controller alone, GetControllerEventKey.
+	 */
+	struct ControllerAxisValueChangedEvent : InputEvent
 	{
 		DECLARE_EVENT_TYPE(ControllerAxisValueChangedEvent);
+		DECLARE_EVENT_KEY(GetControllerAxisEventKey(m_controllerIndex, m_axis));
+		DECLARE_EVENT_GROUP_KEY(GetControllerEventKey(m_controllerIndex));
 		oxyS32 m_controllerIndex{};
 		ControllerAxis m_axis{};
 		oxyF32 m_value{};
 		oxyF32 m_prevValue{};
 	};
 
-	struct ControllerButtonStateChangedEvent : Event
+	/**
+	 * @brief Keyed on controller and button, GetControllerButtonEventKey,
+	 * and on the controller alone, GetControllerEventKey.
+	 */
+	struct ControllerButtonStateChangedEvent : InputEvent
 	{
 		DECLARE_EVENT_TYPE(ControllerButtonStateChangedEvent);
+		DECLARE_EVENT_KEY(
+			GetControllerButtonEventKey(m_controllerIndex, m_button));
+		DECLARE_EVENT_GROUP_KEY(GetControllerEventKey(m_controllerIndex));
 		oxyS32 m_controllerIndex{};
 		ControllerButton m_button{};
 		oxyBool m_isDown{};
 	};
 
+	struct InputActionStateChangedEvent : InputEvent
+	{
+		DECLARE_EVENT_TYPE(InputActionStateChangedEvent);
+		DECLARE_EVENT_KEY(m_action);
+		// Index returned by InputActionMap::AddAction
+		oxyU32 m_action{};
+		oxyBool m_isActive{};
+		oxyF32 m_value{};
+		oxyF32 m_prevValue{};
+	};
+
 	struct Scene;
 	struct SceneChangedEvent : Event
 	{
@@ -5,15 +5,15 @@
 namespace oxygen
 {
 	auto InternalRegisterEventListener(EventType type, void* object,
-									   void (*callback)(void*, const Event&))
-		-> void
+									   void (*callback)(void*, const Event&),
+									   oxyU32 key, const char* name)
+		-> EventListenerHandle
 	{
-		EventManager::GetInstance().RegisterListener(type, callback, object);
+		return EventManager::GetInstance().RegisterListener(type, callback,
+															object, key, name);
 	}
-	auto InternalUnregisterEventListeners(EventType type, void* object,
-										  void (*callback)(void*, const Event&))
-		-> void
+	auto InternalUnregisterEventListener(EventListenerHandle handle) -> void
 	{
-		EventManager::GetInstance().UnregisterListeners(type, callback, object);
+		EventManager::GetInstance().UnregisterListener(handle);
 	}
 }; // namespace oxygen
@@ -5,18 +5,23 @@
 namespace oxygen
 {
 	auto InternalRegisterEventListener(EventType type, void* object,
-									   void (*callback)(void*, const Event&))
-		-> void;
-	auto InternalUnregisterEventListeners(EventType type, void* object,
-										  void (*callback)(void*, const Event&))
-		-> void;
+									   void (*callback)(void*, const Event&),
+									   oxyU32 key, const char* name)
+		-> EventListenerHandle;
+	auto InternalUnregisterEventListener(EventListenerHandle handle) -> void;
 
 	/**
 	 * @brief Instantiating this class will register an event listener for the
 	 * given event type. It will call the given member function passed in the
 	 * template parameter when the event is triggered. Construct via passing in
-	 * a pointer to the object that owns the member function.
+	 * a pointer to the object that owns the member function, and optionally a
+	 * key to only receive events whose GetKey() or GetGroupKey() matches. The
+	 * key must come from the event's own scheme, e.g. a KeyboardButton,
+	 * GetControllerButtonEventKey() or GetControllerEventKey(). A bare
+	 * controller index is only valid for ControllerConnectionStateChangedEvent.
 	 * @tparam EventToListenTo The event type that this listener will listen to.
+	 * Pass EventType_Invalid to take it from the member function's event
+	 * parameter, required for events declared with DECLARE_RUNTIME_EVENT_TYPE.
 	 * @tparam MemberFunctionPtr The member function that will be called when
 	 */
 	template <EventType EventToListenTo, auto MemberFunctionPtr>
@@ -36,15 +41,16 @@ namespace oxygen
 		using ObjectType = FuncDetails::object_type;
 		using EventParamType = FuncDetails::arg_type;
 
-		EventListener(ObjectType* object) : m_objectPtr(object)
+		EventListener(ObjectType* object, oxyU32 key = Event::k_noKey)
+			: m_objectPtr(object)
 		{
-			InternalRegisterEventListener(EventToListenTo, m_objectPtr,
-										  &EventListener::Invoke);
+			m_handle = InternalRegisterEventListener(
+				GetListenedType(), m_objectPtr, &EventListener::Invoke, key,
+				GetName());
 		}
 		~EventListener()
 		{
-			InternalUnregisterEventListeners(EventToListenTo, m_objectPtr,
-											 &EventListener::Invoke);
+			InternalUnregisterEventListener(m_handle);
 		}
 		static inline auto Invoke(void* object, const Event& event) -> void
 		{
@@ -52,6 +58,34 @@ namespace oxygen
 			const auto castedEvent = static_cast<EventParamType>(event);
 			(castedObject->*MemberFunctionPtr)(castedEvent);
 		}
+		/**
+		 * @brief Compiler generated signature of this instantiation, used to
+		 * identify the listener in EventManager stats.
+		 */
+		static inline auto GetName() -> const char*
+		{
+#ifdef _MSC_VER
+			return __FUNCSIG__;
+#else
+			return __PRETTY_FUNCTION__;
+#endif
+		}
+		static inline auto GetListenedType() -> EventType
+		{
+			if constexpr (EventToListenTo != EventType_Invalid)
+				return EventToListenTo;
+			else
+				return std::remove_cvref_t<EventParamType>::GetStaticType();
+		}
 		ObjectType* m_objectPtr{};
+		EventListenerHandle m_handle{};
 	};
+
+	/**
+	 * @brief EventListener that takes its event type from the member function,
+	 * works for both built-in and runtime event types.
+	 */
+	template <auto MemberFunctionPtr>
+	using TypedEventListener =
+		EventListener<EventType_Invalid, MemberFunctionPtr>;
 }; // namespace oxygen
\ No newline at end of file
@@ -1,27 +1,104 @@
 #include "OxygenPCH.h"
 #include "EventManager.h"
 
+#include "Platform/Platform.h"
+
+#include <cstdio>
+
 namespace oxygen
 {
+	static_assert(k_controllerKeyBase + OXYGENMAXCONTROLLERS <=
+					  EventManager::k_maxEventKeys,
+				  "Controller event keys must fit the keyed listener arrays");
+
 	auto EventManager::RegisterListener(EventType type,
 										EventCallbackType callback,
-										void* userPointer) -> void
+										void* userPointer, oxyU32 key,
+										const char* name)
+		-> EventListenerHandle
 	{
-		m_callbacksToRegister.emplace_back(
-			type, std::make_pair(userPointer, callback));
+		OXYCHECK(type != EventType_Invalid);
+		OXYCHECK(key == Event::k_noKey || key < k_maxEventKeys);
+		if (type >= m_listeners.size())
+			m_listeners.resize(type + 1);
+		auto& table = m_listeners[type];
+		if (key != Event::k_noKey && key >= table.m_keyed.size())
+			table.m_keyed.resize(key + 1);
+		oxyU32 handleIndex{};
+		if (!m_freeHandleSlots.empty())
+		{
+			handleIndex = m_freeHandleSlots.back();
+			m_freeHandleSlots.pop_back();
+		}
+		else
+		{
+			handleIndex = static_cast<oxyU32>(m_handleSlots.size());
+			m_handleSlots.emplace_back();
+		}
+		// Appending is safe during dispatch, the dispatch loop only visits the
+		// listeners that were present when it started.
+		auto& listeners = GetListenerArray(type, key)->m_slots;
+		auto& handleSlot = m_handleSlots[handleIndex];
+		handleSlot.m_type = type;
+		handleSlot.m_key = key;
+		handleSlot.m_slotIndex = static_cast<oxyU32>(listeners.size());
+		listeners.push_back({userPointer, callback, handleIndex});
+		if (name)
+			m_listenerNames[callback] = name;
+		return {handleIndex, handleSlot.m_generation};
 	}
 
-	auto EventManager::UnregisterListeners(EventType type,
-										   EventCallbackType callback,
-										   void* userPointer) -> void
+	auto EventManager::UnregisterListener(EventListenerHandle handle) -> void
 	{
-		m_callbacksToUnregister.emplace_back(
-			type, std::make_pair(userPointer, callback));
+		if (!handle.IsValid() || handle.m_index >= m_handleSlots.size())
+			return;
+		auto& handleSlot = m_handleSlots[handle.m_index];
+		if (handleSlot.m_generation != handle.m_generation)
+			return;
+		auto& array = *GetListenerArray(handleSlot.m_type, handleSlot.m_key);
+		auto& listeners = array.m_slots;
+		const auto slotIndex = handleSlot.m_slotIndex;
+		if (m_dispatchDepth)
+		{
+			// Leave a tombstone so indices held by the dispatch loop stay
+			// valid, CompactListeners removes it afterwards.
+			listeners[slotIndex].m_callback = nullptr;
+			if (!array.m_hasTombstones)
+			{
+				array.m_hasTombstones = true;
+				m_arraysWithTombstones.push_back(
+					{handleSlot.m_type, handleSlot.m_key});
+			}
+			return;
+		}
+		if (slotIndex != listeners.size() - 1)
+		{
+			listeners[slotIndex] = listeners.back();
+			m_handleSlots[listeners[slotIndex].m_handleIndex].m_slotIndex =
+				slotIndex;
+		}
+		listeners.pop_back();
+		handleSlot.m_generation++;
+		if (!handleSlot.m_generation)
+			handleSlot.m_generation++;
+		m_freeHandleSlots.push_back(handle.m_index);
+	}
+
+	auto EventManager::GetListenerCount(EventType type, oxyU32 key) const
+		-> oxySize
+	{
+		if (type >= m_listeners.size())
+			return 0;
+		const auto& table = m_listeners[type];
+		if (key == Event::k_noKey)
+			return table.m_unkeyed.m_slots.size();
+		if (key >= table.m_keyed.size())
+			return 0;
+		return table.m_keyed[key].m_slots.size();
 	}
 
 	auto EventManager::ProcessEvents(oxyS32 lim) -> void
 	{
-		ProcessCallbackAdditionAndRemoval();
 		size_t max = m_eventQueue.size();
 		if (lim != -1)
 			max = lim;
@@ -40,35 +117,73 @@ namespace oxygen
 		}
 	}
 
-	auto EventManager::ProcessCallbackAdditionAndRemoval() -> void
+	auto EventManager::GetListenerArray(EventType type, oxyU32 key)
+		-> ListenerArray*
 	{
-		if (!m_callbacksToRegister.empty())
+		if (type >= m_listeners.size())
+			return nullptr;
+		auto& table = m_listeners[type];
+		if (key == Event::k_noKey)
+			return &table.m_unkeyed;
+		if (key >= table.m_keyed.size())
+			return nullptr;
+		return &table.m_keyed[key];
+	}
+
+	auto EventManager::CompactListeners() -> void
+	{
+		for (const auto& id : m_arraysWithTombstones)
 		{
-			for (const auto& [type, cb] : m_callbacksToRegister)
+			auto& array = *GetListenerArray(id.m_type, id.m_key);
+			auto& listeners = array.m_slots;
+			array.m_hasTombstones = false;
+			oxySize write{};
+			for (oxySize read = 0; read < listeners.size(); ++read)
 			{
-				m_eventCallbacks.emplace(type, cb);
+				auto& handleSlot =
+					m_handleSlots[listeners[read].m_handleIndex];
+				if (!listeners[read].m_callback)
+				{
+					handleSlot.m_generation++;
+					if (!handleSlot.m_generation)
+						handleSlot.m_generation++;
+					m_freeHandleSlots.push_back(listeners[read].m_handleIndex);
+					continue;
+				}
+				handleSlot.m_slotIndex = static_cast<oxyU32>(write);
+				listeners[write++] = listeners[read];
 			}
-			m_callbacksToRegister.clear();
+			listeners.resize(write);
 		}
-		if (!m_callbacksToUnregister.empty())
+		m_arraysWithTombstones.clear();
+	}
+
+	auto EventManager::DispatchToListeners(EventType type, oxyU32 key,
+										   const Event& event) -> void
+	{
+		const auto listeners = GetListenerArray(type, key);
+		if (!listeners)
+			return;
+		// Listeners registered by a callback are not invoked for this event.
+		const auto count = listeners->m_slots.size();
+		for (oxySize i = 0; i < count; ++i)
 		{
-			for (const auto& [type, cb] : m_callbacksToUnregister)
+			// Copy and re-fetch every iteration, a callback may grow the
+			// arrays and reallocate them.
+			const auto listener = GetListenerArray(type, key)->m_slots[i];
+			if (!listener.m_callback)
+				continue;
+			if (!m_statsEnabled)
 			{
-				const auto range = m_eventCallbacks.equal_range(type);
-				for (auto it = range.first; it != range.second;)
-				{
-					if (it->second.first == cb.first &&
-						it->second.second == cb.second)
-					{
-						it = m_eventCallbacks.erase(it);
-					}
-					else
-					{
-						++it;
-					}
-				}
+				listener.m_callback(listener.m_userPointer, event);
+			}
+			else
+			{
+				const auto callStart = GetHighPrecisionTime();
+				listener.m_callback(listener.m_userPointer, event);
+				RecordListenerCall(type, listener.m_callback,
+								   GetHighPrecisionTime() - callStart);
 			}
-			m_callbacksToUnregister.clear();
 		}
 	}
 
@@ -78,14 +193,149 @@ namespace oxygen
 			return;
 		const auto event = m_eventQueue.top();
 		m_eventQueue.pop();
-		const auto range = m_eventCallbacks.equal_range(event->GetType());
-		for (auto it = range.first; it != range.second; ++it)
+		DispatchEvent(*event);
+		delete event;
+	}
+
+	auto EventManager::DispatchEvent(const Event& event) -> void
+	{
+		const auto type = event.GetType();
+		const auto key = event.GetKey();
+		const auto groupKey = event.GetGroupKey();
+		const auto dispatchStart = m_statsEnabled ? GetHighPrecisionTime() : 0;
+		m_dispatchDepth++;
+		DispatchToListeners(type, Event::k_noKey, event);
+		if (key != Event::k_noKey)
+			DispatchToListeners(type, key, event);
+		if (groupKey != Event::k_noKey)
+			DispatchToListeners(type, groupKey, event);
+		m_dispatchDepth--;
+		if (m_statsEnabled)
 		{
-			const auto cb = it->second.second;
-			if (cb)
-				cb(it->second.first, *event);
+			if (type >= m_eventTypeStats.size())
+				m_eventTypeStats.resize(type + 1);
+			auto& stats = m_eventTypeStats[type];
+			stats.m_name = event.GetTypeStr();
+			stats.m_dispatched++;
+			stats.m_time += GetHighPrecisionTime() - dispatchStart;
 		}
-		delete event;
+		if (!m_dispatchDepth && !m_arraysWithTombstones.empty())
+			CompactListeners();
+	}
+
+	auto EventManager::SetStatsEnabled(oxyBool enabled) -> void
+	{
+		m_statsEnabled = enabled;
+	}
+
+	auto EventManager::IsStatsEnabled() const -> oxyBool
+	{
+		return m_statsEnabled;
+	}
+
+	auto EventManager::ResetStats() -> void
+	{
+		m_peakQueueDepth = m_eventQueue.size();
+		for (auto& stats : m_eventTypeStats)
+			stats = {stats.m_name};
+		m_listenerStats.clear();
+	}
+
+	auto EventManager::GetEventTypeStats(EventType type) const
+		-> const EventTypeStats&
+	{
+		static const EventTypeStats k_empty{};
+		if (type >= m_eventTypeStats.size())
+			return k_empty;
+		return m_eventTypeStats[type];
+	}
+
+	auto EventManager::GetPeakQueueDepth() const -> oxySize
+	{
+		return m_peakQueueDepth;
+	}
+
+	auto EventManager::GetListenerStats() const
+		-> std::vector<EventListenerStats>
+	{
+		std::vector<EventListenerStats> result{};
+		result.reserve(m_listenerStats.size());
+		for (const auto& [cb, stats] : m_listenerStats)
+			result.push_back(stats);
+		std::ranges::sort(result, [](const auto& lhs, const auto& rhs) {
+			return lhs.m_time > rhs.m_time;
+		});
+		return result;
+	}
+
+	auto EventManager::DumpStats() const -> std::string
+	{
+		std::string out{};
+		char line[512]{};
+		std::snprintf(line, sizeof line, "Event stats (peak queue depth %zu)\n",
+					  m_peakQueueDepth);
+		out += line;
+		for (oxySize i = EventType_Invalid + 1; i < m_eventTypeStats.size();
+			 ++i)
+		{
+			const auto& stats = m_eventTypeStats[i];
+			if (!stats.m_queued && !stats.m_dispatched)
+				continue;
+			std::snprintf(line, sizeof line,
+						  "  %s: queued %8llu dispatched %8llu time %10.3fus\n",
+						  stats.m_name ? stats.m_name : "<unknown>",
+						  static_cast<unsigned long long>(stats.m_queued),
+						  static_cast<unsigned long long>(stats.m_dispatched),
+						  HighPrecisionTimeToSeconds(stats.m_time) * 1e6);
+			out += line;
+		}
+		for (const auto& stats : GetListenerStats())
+		{
+			std::snprintf(
+				line, sizeof line,
+				"  listener %s (type %u): calls %8llu time %10.3fus max "
+				"%10.3fus\n",
+				stats.m_name ? stats.m_name : "<unnamed>", stats.m_type,
+				static_cast<unsigned long long>(stats.m_calls),
+				HighPrecisionTimeToSeconds(stats.m_time) * 1e6,
+				HighPrecisionTimeToSeconds(stats.m_maxTime) * 1e6);
+			out += line;
+		}
+		return out;
+	}
+
+	auto EventManager::RecordQueuedEvent(EventType type, const char* name)
+		-> void
+	{
+		if (type >= m_eventTypeStats.size())
+			m_eventTypeStats.resize(type + 1);
+		auto& stats = m_eventTypeStats[type];
+		stats.m_name = name;
+		stats.m_queued++;
+		m_peakQueueDepth = std::max(m_peakQueueDepth, m_eventQueue.size());
+	}
+
+	auto EventManager::RecordListenerCall(EventType type,
+										  EventCallbackType callback,
+										  oxyU64 time) -> void
+	{
+		auto& stats = m_listenerStats[callback];
+		if (!stats.m_callback)
+		{
+			const auto name = m_listenerNames.find(callback);
+			stats.m_name =
+				name != m_listenerNames.end() ? name->second : nullptr;
+			stats.m_callback = callback;
+			stats.m_type = type;
+		}
+		stats.m_calls++;
+		stats.m_time += time;
+		stats.m_maxTime = std::max(stats.m_maxTime, time);
+		oxySize bucket{};
+		while (bucket < EventListenerStats::k_histogramBuckets - 1 &&
+			   (oxyU64{1} << bucket) <= time)
+			bucket++;
+		stats.m_histogram[bucket]++;
 	}
 
 }; // namespace oxygen
\ No newline at end of file
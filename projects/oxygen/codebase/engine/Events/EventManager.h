@@ -21,6 +21,12 @@ namespace oxygen
 		 */
 		using EventCallbackType = void (*)(void*, const Event&);
 
+		/**
+		 * @brief Keyed listeners are stored in an array indexed by key, keys
+		 * must be small dense values such as enum members.
+		 */
+		static inline constexpr oxyU32 k_maxEventKeys{0x1000};
+
 		/**
 		 * @brief Used to register a callback for a given event type.
 		 * EventListener wraps this into a more convenient pattern.
@@ -29,15 +35,30 @@ namespace oxygen
 		 * triggered.
 		 * @param userPointer A user supplied pointer that will be passed to the
 		 * callback.
+		 * @param key Optional filter, the callback is then only invoked for
+		 * events whose GetKey() or GetGroupKey() matches. Event::k_noKey
+		 * receives every event of the type.
+		 * @param name Optional static string identifying the listener in
+		 * stats dumps.
+		 * @return Handle to pass to UnregisterListener.
 		 */
 		auto RegisterListener(EventType type, EventCallbackType callback,
-							  void* userPointer) -> void;
+							  void* userPointer, oxyU32 key = Event::k_noKey,
+							  const char* name = nullptr)
+			-> EventListenerHandle;
 		/**
-		 * @brief Used to unregister a callback for a given event type. Pass in
-		 * the same arguments that were passed to RegisterListener.
+		 * @brief Used to unregister a callback in constant time. If called
+		 * during dispatch the listener is tombstoned and removed once dispatch
+		 * returns. Stale or invalid handles are ignored.
 		 */
-		auto UnregisterListeners(EventType type, EventCallbackType callback,
-								 void* userPointer) -> void;
+		auto UnregisterListener(EventListenerHandle handle) -> void;
+		/**
+		 * @brief Number of listeners registered for the type and key,
+		 * counting the ones unregistered during a dispatch that has not
+		 * returned yet.
+		 */
+		auto GetListenerCount(EventType type,
+							  oxyU32 key = Event::k_noKey) const -> oxySize;
 
 		/**
 		 * @brief Submit an event to the event queue.
@@ -49,6 +70,31 @@ namespace oxygen
 						  "EventT must be derived from Event");
 			const auto event = new EventT(std::forward<Args>(args)...);
 			m_eventQueue.push(event);
+			if (m_statsEnabled)
+				RecordQueuedEvent(EventT::GetStaticType(),
+								  EventT::GetStaticTypeStr());
+		}
+
+		/**
+		 * @brief Construct an event on the stack and dispatch it to the
+		 * registered listeners before returning, skipping the queue and its
+		 * heap allocation.
+		 *
+		 * @details Re-entrancy rules, these also hold for queued events:
+		 * - Listeners may call TriggerEvent (nested dispatch) and QueueEvent.
+		 * - A listener registered during dispatch is not invoked for the event
+		 *   currently being dispatched, it receives the next one.
+		 * - A listener unregistered during dispatch is not invoked anymore,
+		 *   even by the event currently being dispatched. Its storage is
+		 *   reclaimed when the outermost dispatch returns.
+		 */
+		template <typename EventT, typename... Args>
+		auto TriggerEvent(Args&&... args) -> void
+		{
+			static_assert(std::is_base_of_v<Event, EventT>,
+						  "EventT must be derived from Event");
+			const EventT event{std::forward<Args>(args)...};
+			DispatchEvent(event);
 		}
 
 		/**
@@ -57,19 +103,107 @@ namespace oxygen
 		 */
 		auto ProcessEvents(oxyS32 lim = -1) -> void;
 
+		/**
+		 * @brief Counters for a single event type, accumulated since the last
+		 * ResetStats call.
+		 */
+		struct EventTypeStats
+		{
+			const char* m_name{};
+			oxyU64 m_queued{};
+			oxyU64 m_dispatched{};
+			oxyU64 m_time{};
+		};
+
+		/**
+		 * @brief Timing for a single listener callback, accumulated since the
+		 * last ResetStats call. Histogram bucket i counts calls that took
+		 * less than 2^i high precision time units.
+		 */
+		struct EventListenerStats
+		{
+			static inline constexpr oxySize k_histogramBuckets{24};
+
+			const char* m_name{};
+			EventCallbackType m_callback{};
+			EventType m_type{};
+			oxyU64 m_calls{};
+			oxyU64 m_time{};
+			oxyU64 m_maxTime{};
+			oxyU32 m_histogram[k_histogramBuckets]{};
+		};
+
+		/**
+		 * @brief Stats are off by default, enabling them adds two timer reads
+		 * per listener call.
+		 */
+		auto SetStatsEnabled(oxyBool enabled) -> void;
+		auto IsStatsEnabled() const -> oxyBool;
+		auto ResetStats() -> void;
+
+		auto GetEventTypeStats(EventType type) const -> const EventTypeStats&;
+		auto GetPeakQueueDepth() const -> oxySize;
+		/**
+		 * @brief Returns the listener stats sorted by total time spent, the
+		 * slowest listener first.
+		 */
+		auto GetListenerStats() const -> std::vector<EventListenerStats>;
+		/**
+		 * @brief Formats all collected stats into a human readable string.
+		 * Intended to be called once per frame followed by ResetStats.
+		 */
+		auto DumpStats() const -> std::string;
+
 		~EventManager();
 	  private:
 		// Listeners:
-		using MapValuePairType = std::pair<void*, EventCallbackType>;
-		std::unordered_multimap<EventType, MapValuePairType> m_eventCallbacks{};
-		// Callbacks could potentially be registered/unregistered during a
-		// callback, these vectors will be used to instead delay the
-		// insertion/removal in the map until ProcessEvents is called
-		std::vector<std::pair<EventType, MapValuePairType>>
-			m_callbacksToRegister{};
-		std::vector<std::pair<EventType, MapValuePairType>>
-			m_callbacksToUnregister{};
-		auto ProcessCallbackAdditionAndRemoval() -> void;
+		// Dense per type arrays, a null callback marks a tombstone left by an
+		// unregistration during dispatch.
+		struct ListenerSlot
+		{
+			void* m_userPointer{};
+			EventCallbackType m_callback{};
+			oxyU32 m_handleIndex{};
+		};
+		struct ListenerArray
+		{
+			std::vector<ListenerSlot> m_slots{};
+			// Set while the array is listed in m_arraysWithTombstones, so
+			// each array is listed once however many listeners it loses.
+			oxyBool m_hasTombstones{};
+		};
+		struct ListenerTable
+		{
+			ListenerArray m_unkeyed{};
+			// Indexed by key, an event visits its key and group key buckets.
+			std::vector<ListenerArray> m_keyed{};
+		};
+		// Indexed by EventType, grows when a runtime event type is first
+		// listened to.
+		std::vector<ListenerTable> m_listeners{};
+		auto GetListenerArray(EventType type, oxyU32 key) -> ListenerArray*;
+		// Handle table, maps handle index to the listener's current position.
+		struct ListenerHandleSlot
+		{
+			oxyU32 m_generation{1};
+			EventType m_type{};
+			oxyU32 m_key{};
+			oxyU32 m_slotIndex{};
+		};
+		std::vector<ListenerHandleSlot> m_handleSlots{};
+		std::vector<oxyU32> m_freeHandleSlots{};
+		// Listeners may be registered/unregistered during a callback, removal
+		// is then deferred until the outermost dispatch returns.
+		oxyU32 m_dispatchDepth{};
+		struct ListenerArrayID
+		{
+			EventType m_type{};
+			oxyU32 m_key{};
+		};
+		std::vector<ListenerArrayID> m_arraysWithTombstones{};
+		auto CompactListeners() -> void;
+		auto DispatchToListeners(EventType type, oxyU32 key,
+								 const Event& event) -> void;
 
 		// Queue:
 		// Must declare a comparison type for the priority queue
@@ -85,5 +219,18 @@ namespace oxygen
 			m_eventQueue{};
 
 		auto ProcessOneEvent() -> void;
+		auto DispatchEvent(const Event& event) -> void;
+
+		// Stats:
+		oxyBool m_statsEnabled{};
+		oxySize m_peakQueueDepth{};
+		std::vector<EventTypeStats> m_eventTypeStats{};
+		std::unordered_map<EventCallbackType, const char*, Hasher>
+			m_listenerNames{};
+		std::unordered_map<EventCallbackType, EventListenerStats, Hasher>
+			m_listenerStats{};
+		auto RecordQueuedEvent(EventType type, const char* name) -> void;
+		auto RecordListenerCall(EventType type, EventCallbackType callback,
+								oxyU64 time) -> void;
 	};
 }; // namespace oxygen
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "OxygenPCH.h"
+#include "Events/EventSelfCheck.h"
+
+#include "Events/EventListener.h"
+#include "Events/EventManager.h"
+
+namespace oxygen
+{
+	namespace
+	{
+		/**
+		 * @brief Runtime event type so the checks do not reach listeners of
+		 * the built-in types.
+		 */
+		struct EventSelfCheckEvent : Event
+		{
+			DECLARE_RUNTIME_EVENT_TYPE(EventSelfCheckEvent);
+			oxyU32 m_depth{};
+		};
+
+		/**
+		 * @brief Listeners 0 to count - 1 registered in order, each with its
+		 * own call counter, unregistered when the check returns. What a
+		 * listener does when invoked is picked by the check through
+		 * m_action.
+		 */
+		struct SelfCheckListeners
+		{
+			static inline constexpr oxySize k_maxListeners{4};
+
+			struct Listener
+			{
+				SelfCheckListeners* m_owner{};
+				oxySize m_index{};
+			};
+
+			EventManager& m_events;
+			auto (*m_action)(SelfCheckListeners&, oxySize index,
+							 const EventSelfCheckEvent& event) -> void {};
+			oxyU32 m_calls[k_maxListeners]{};
+			EventListenerHandle m_handles[k_maxListeners]{};
+			Listener m_listeners[k_maxListeners]{};
+			// Free for the checks to record state seen during dispatch
+			oxySize m_observedCount{};
+
+			SelfCheckListeners(EventManager& events, oxySize count)
+				: m_events(events)
+			{
+				for (oxySize i = 0; i < count; ++i)
+					Register(i);
+			}
+			~SelfCheckListeners()
+			{
+				for (const auto handle : m_handles)
+					m_events.UnregisterListener(handle);
+			}
+			auto Register(oxySize index) -> void
+			{
+				m_listeners[index] = {this, index};
+				m_handles[index] = m_events.RegisterListener(
+					EventSelfCheckEvent::GetStaticType(), &Invoke,
+					&m_listeners[index]);
+			}
+			auto GetCount() const -> oxySize
+			{
+				return m_events.GetListenerCount(
+					EventSelfCheckEvent::GetStaticType());
+			}
+			static auto Invoke(void* userPointer, const Event& event) -> void
+			{
+				const auto& listener = *static_cast<Listener*>(userPointer);
+				auto& owner = *listener.m_owner;
+				owner.m_calls[listener.m_index]++;
+				if (owner.m_action)
+					owner.m_action(
+						owner, listener.m_index,
+						static_cast<const EventSelfCheckEvent&>(event));
+			}
+		};
+
+		// Listener 0 registers listener 1, which must only receive the next
+		// event.
+		auto CheckRegisterDuringTrigger(EventManager& events) -> oxyBool
+		{
+			SelfCheckListeners listeners{events, 1};
+			listeners.m_action = [](SelfCheckListeners& listeners,
+									oxySize index, const EventSelfCheckEvent&) {
+				if (index == 0 && !listeners.m_handles[1].IsValid())
+					listeners.Register(1);
+			};
+			events.TriggerEvent<EventSelfCheckEvent>();
+			const auto first =
+				listeners.m_calls[0] == 1 && listeners.m_calls[1] == 0;
+			events.TriggerEvent<EventSelfCheckEvent>();
+			return first && listeners.m_calls[0] == 2 &&
+				   listeners.m_calls[1] == 1 && listeners.GetCount() == 2;
+		}
+
+		// Listener 0 unregisters itself, listener 1 must still be invoked.
+		auto CheckUnregisterSelf(EventManager& events) -> oxyBool
+		{
+			SelfCheckListeners listeners{events, 2};
+			listeners.m_action = [](SelfCheckListeners& listeners,
+									oxySize index, const EventSelfCheckEvent&) {
+				if (index == 0)
+					listeners.m_events.UnregisterListener(
+						listeners.m_handles[0]);
+			};
+			events.TriggerEvent<EventSelfCheckEvent>();
+			events.TriggerEvent<EventSelfCheckEvent>();
+			return listeners.m_calls[0] == 1 && listeners.m_calls[1] == 2 &&
+				   listeners.GetCount() == 1;
+		}
+
+		// Listener 0 unregisters listener 2, which must not be invoked by
+		// the event being dispatched.
+		auto CheckUnregisterLater(EventManager& events) -> oxyBool
+		{
+			SelfCheckListeners listeners{events, 3};
+			listeners.m_action = [](SelfCheckListeners& listeners,
+									oxySize index, const EventSelfCheckEvent&) {
+				if (index == 0)
+					listeners.m_events.UnregisterListener(
+						listeners.m_handles[2]);
+			};
+			events.TriggerEvent<EventSelfCheckEvent>();
+			return listeners.m_calls[0] == 1 && listeners.m_calls[1] == 1 &&
+				   listeners.m_calls[2] == 0 && listeners.GetCount() == 2;
+		}
+
+		// Listener 0 triggers the same type again and unregisters listener
+		// 2 from the nested dispatch. The outer dispatch must skip it too,
+		// and keep its tombstone until the outer dispatch returns.
+		auto CheckNestedTrigger(EventManager& events) -> oxyBool
+		{
+			SelfCheckListeners listeners{events, 3};
+			listeners.m_action = [](SelfCheckListeners& listeners,
+									oxySize index,
+									const EventSelfCheckEvent& event) {
+				if (index != 0)
+					return;
+				if (event.m_depth)
+				{
+					listeners.m_events.UnregisterListener(
+						listeners.m_handles[2]);
+					return;
+				}
+				EventSelfCheckEvent nested{};
+				nested.m_depth = event.m_depth + 1;
+				listeners.m_events.TriggerEvent<EventSelfCheckEvent>(nested);
+				listeners.m_observedCount = listeners.GetCount();
+			};
+			events.TriggerEvent<EventSelfCheckEvent>();
+			return listeners.m_calls[0] == 2 && listeners.m_calls[1] == 2 &&
+				   listeners.m_calls[2] == 0 &&
+				   listeners.m_observedCount == 3 && listeners.GetCount() == 2;
+		}
+
+		// Listener 0 unregisters listener 1 while ProcessEvents dispatches
+		// the first of two queued events. After compaction the stale handle
+		// must not remove the listener that reuses its slot.
+		auto CheckUnregisterDuringProcess(EventManager& events) -> oxyBool
+		{
+			SelfCheckListeners listeners{events, 2};
+			listeners.m_action = [](SelfCheckListeners& listeners,
+									oxySize index, const EventSelfCheckEvent&) {
+				if (index == 0)
+					listeners.m_events.UnregisterListener(
+						listeners.m_handles[1]);
+			};
+			events.QueueEvent<EventSelfCheckEvent>();
+			events.QueueEvent<EventSelfCheckEvent>();
+			events.ProcessEvents();
+			const auto processed = listeners.m_calls[0] == 2 &&
+								   listeners.m_calls[1] == 0 &&
+								   listeners.GetCount() == 1;
+			listeners.m_action = nullptr;
+			listeners.Register(2);
+			events.UnregisterListener(listeners.m_handles[1]);
+			events.TriggerEvent<EventSelfCheckEvent>();
+			return processed && listeners.m_calls[2] == 1 &&
+				   listeners.GetCount() == 2;
+		}
+
+		// Controller 1 listened to per button, per controller and, for
+		// connection events, by the bare controller index.
+		struct ControllerKeyListeners
+		{
+			oxyU32 m_button{};
+			oxyU32 m_controller{};
+			oxyU32 m_otherController{};
+			oxyU32 m_connection{};
+
+			auto OnButton(const ControllerButtonStateChangedEvent&) -> void
+			{
+				m_button++;
+			}
+			auto OnController(const ControllerButtonStateChangedEvent& event)
+				-> void
+			{
+				if (event.m_controllerIndex == 1)
+					m_controller++;
+				else
+					m_otherController++;
+			}
+			auto OnConnection(const ControllerConnectionStateChangedEvent&)
+				-> void
+			{
+				m_connection++;
+			}
+
+			TypedEventListener<&ControllerKeyListeners::OnButton>
+				m_buttonListener{
+					this, GetControllerButtonEventKey(1, ControllerButton_B)};
+			TypedEventListener<&ControllerKeyListeners::OnController>
+				m_controllerListener{this, GetControllerEventKey(1)};
+			TypedEventListener<&ControllerKeyListeners::OnConnection>
+				m_connectionListener{this, 1};
+		};
+
+		auto CheckControllerKeys(EventManager& events) -> oxyBool
+		{
+			ControllerKeyListeners listeners{};
+			for (oxyS32 i = 0; i < OXYGENMAXCONTROLLERS; ++i)
+			{
+				ControllerConnectionStateChangedEvent connection{};
+				connection.m_controllerIndex = i;
+				events.TriggerEvent<ControllerConnectionStateChangedEvent>(
+					connection);
+				for (oxyU8 j = 0; j < ControllerButton_Count; ++j)
+				{
+					ControllerButtonStateChangedEvent button{};
+					button.m_controllerIndex = i;
+					button.m_button = static_cast<ControllerButton>(j);
+					events.TriggerEvent<ControllerButtonStateChangedEvent>(
+						button);
+				}
+			}
+			return listeners.m_button == 1 &&
+				   listeners.m_controller == ControllerButton_Count &&
+				   !listeners.m_otherController &&
+				   listeners.m_connection == 1;
+		}
+	}; // namespace
+
+	auto RunEventSelfCheck() -> std::vector<std::string_view>
+	{
+		struct SelfCheck
+		{
+			std::string_view m_name;
+			auto (*m_run)(EventManager&) -> oxyBool;
+		};
+		static constexpr SelfCheck k_checks[]{
+			{"register_during_trigger", &CheckRegisterDuringTrigger},
+			{"unregister_self", &CheckUnregisterSelf},
+			{"unregister_later", &CheckUnregisterLater},
+			{"nested_trigger", &CheckNestedTrigger},
+			{"unregister_during_process", &CheckUnregisterDuringProcess},
+			{"controller_keys", &CheckControllerKeys},
+		};
+		auto& events = EventManager::GetInstance();
+		std::vector<std::string_view> failed{};
+		for (const auto& check : k_checks)
+		{
+			if (!check.m_run(events))
+				failed.push_back(check.m_name);
+		}
+		return failed;
+	}
+}; // namespace oxygen
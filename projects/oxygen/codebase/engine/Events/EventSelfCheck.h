@@ -0,0 +1,14 @@
+#pragma once
+
+namespace oxygen
+{
+	/**
+	 * @brief Exercises the EventManager re-entrancy rules documented on
+	 * TriggerEvent: registering and unregistering listeners from a callback,
+	 * nested dispatch of the same type, unregistering during ProcessEvents and
+	 * the compaction that follows, and keyed controller events. Needs the
+	 * EventManager singleton and an empty event queue.
+	 * @return The names of the checks that failed, empty if all passed.
+	 */
+	auto RunEventSelfCheck() -> std::vector<std::string_view>;
+}; // namespace oxygen
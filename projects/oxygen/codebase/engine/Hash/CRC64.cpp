@@ -0,0 +1,321 @@
+#include "OxygenPCH.h"
+
+#include "Platform/CpuFeatures.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) ||             \
+	defined(__i386__)
+#define OXYHASHCLMUL
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define OXYTARGETCLMUL
+#else
+#define OXYTARGETCLMUL __attribute__((target("pclmul,sse4.1")))
+#endif
+#endif
+
+namespace oxygen
+{
+	namespace
+	{
+		// The polynomial without its x^64 term, g_CRC64Table[1]
+		constexpr oxyU64 k_polynomial = 0x42f0e1eba9ea3693ULL;
+
+		using SliceTables = std::array<std::array<oxyU64, 256>, 16>;
+
+		/**
+		 * @brief Table k holds the CRC of each byte followed by k zero
+		 * bytes, table 0 being g_CRC64Table.
+		 */
+		constexpr auto MakeSliceTables() -> SliceTables
+		{
+			SliceTables tables{};
+			for (oxySize b = 0; b < 256; b++)
+				tables[0][b] = g_CRC64Table[b];
+			for (oxySize k = 1; k < tables.size(); k++)
+			{
+				for (oxySize b = 0; b < 256; b++)
+				{
+					const auto prev = tables[k - 1][b];
+					tables[k][b] = (prev << 8) ^ g_CRC64Table[prev >> 56];
+				}
+			}
+			return tables;
+		}
+		constexpr SliceTables k_sliceTables = MakeSliceTables();
+
+		/**
+		 * @brief The CRC processes bits most significant first, so eight
+		 * bytes are read as a big endian word.
+		 */
+		inline auto LoadBigEndian(const oxyU8* data) -> oxyU64
+		{
+			oxyU64 word{};
+			for (oxySize i = 0; i < 8; i++)
+				word = (word << 8) | data[i];
+			return word;
+		}
+
+		/**
+		 * @brief One table lookup per byte of word, table first + 7 for
+		 * the most significant byte.
+		 */
+		inline auto SliceWord(oxyU64 word, oxySize first) -> oxyU64
+		{
+			const auto& t = k_sliceTables;
+			return t[first + 7][word >> 56] ^
+				   t[first + 6][(word >> 48) & 0xff] ^
+				   t[first + 5][(word >> 40) & 0xff] ^
+				   t[first + 4][(word >> 32) & 0xff] ^
+				   t[first + 3][(word >> 24) & 0xff] ^
+				   t[first + 2][(word >> 16) & 0xff] ^
+				   t[first + 1][(word >> 8) & 0xff] ^ t[first][word & 0xff];
+		}
+
+		auto UpdateTable(oxyU64 crc, const oxyU8* data, oxySize size)
+			-> oxyU64
+		{
+			for (oxySize i = 0; i < size; i++)
+				crc = g_CRC64Table[(crc >> 56) ^ data[i]] ^ (crc << 8);
+			return crc;
+		}
+
+		auto UpdateSlicing8(oxyU64 crc, const oxyU8* data, oxySize size)
+			-> oxyU64
+		{
+			for (; size >= 8; data += 8, size -= 8)
+				crc = SliceWord(crc ^ LoadBigEndian(data), 0);
+			return UpdateTable(crc, data, size);
+		}
+
+		auto UpdateSlicing16(oxyU64 crc, const oxyU8* data, oxySize size)
+			-> oxyU64
+		{
+			for (; size >= 16; data += 16, size -= 16)
+			{
+				crc = SliceWord(crc ^ LoadBigEndian(data), 8) ^
+					  SliceWord(LoadBigEndian(data + 8), 0);
+			}
+			return UpdateSlicing8(crc, data, size);
+		}
+
+		/**
+		 * @brief x^n mod P, the multiplier that moves a 64 bit block n bits
+		 * further down the message.
+		 */
+		constexpr auto ShiftConstant(oxySize n) -> oxyU64
+		{
+			oxyU64 r = 1;
+			for (oxySize i = 0; i < n; i++)
+				r = (r << 1) ^ ((r >> 63) ? k_polynomial : 0);
+			return r;
+		}
+
+		/**
+		 * @brief a * b mod P, most significant bit of b first.
+		 */
+		constexpr auto MultiplyModP(oxyU64 a, oxyU64 b) -> oxyU64
+		{
+			oxyU64 r = 0;
+			for (int i = 63; i >= 0; i--)
+			{
+				r = (r << 1) ^ ((r >> 63) ? k_polynomial : 0);
+				if ((b >> i) & 1)
+					r ^= a;
+			}
+			return r;
+		}
+
+		/**
+		 * @brief Entry k is x^(8 * 2^k) mod P, the shift past 2^k bytes.
+		 */
+		constexpr auto MakeByteShiftTable() -> std::array<oxyU64, 64>
+		{
+			std::array<oxyU64, 64> table{};
+			table[0] = ShiftConstant(8);
+			for (oxySize k = 1; k < table.size(); k++)
+				table[k] = MultiplyModP(table[k - 1], table[k - 1]);
+			return table;
+		}
+		constexpr std::array<oxyU64, 64> k_byteShifts = MakeByteShiftTable();
+
+#ifdef OXYHASHCLMUL
+
+		// Folding over n bits moves the high half of a block n + 64 bits
+		constexpr oxyU64 k_fold512High = ShiftConstant(512 + 64);
+		constexpr oxyU64 k_fold512Low = ShiftConstant(512);
+		constexpr oxyU64 k_fold128High = ShiftConstant(128 + 64);
+		constexpr oxyU64 k_fold128Low = ShiftConstant(128);
+
+		/**
+		 * @brief block * x^n mod P, still 128 bits wide. Unreflected, so
+		 * the plain carry-less products need no extra shift.
+		 */
+		OXYTARGETCLMUL inline auto Fold(__m128i block, __m128i constants)
+			-> __m128i
+		{
+			return _mm_xor_si128(_mm_clmulepi64_si128(block, constants, 0x11),
+								 _mm_clmulepi64_si128(block, constants, 0x00));
+		}
+
+		/**
+		 * @brief The first byte in memory becomes the most significant.
+		 */
+		OXYTARGETCLMUL inline auto LoadBlock(const oxyU8* data) -> __m128i
+		{
+			const auto reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+											  10, 11, 12, 13, 14, 15);
+			return _mm_shuffle_epi8(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)),
+				reverse);
+		}
+
+		/**
+		 * @brief Folds four 128 bit lanes over 512 bit strides, then into
+		 * one lane. What is left is a 128 bit value congruent to the data
+		 * hashed so far, whose CRC the tables finish together with the tail.
+		 */
+		OXYTARGETCLMUL auto UpdateClmul(oxyU64 crc, const oxyU8* data,
+										oxySize size) -> oxyU64
+		{
+			if (size < 64)
+				return UpdateSlicing16(crc, data, size);
+
+			const auto fold512 =
+				_mm_set_epi64x(static_cast<long long>(k_fold512High),
+							   static_cast<long long>(k_fold512Low));
+			const auto fold128 =
+				_mm_set_epi64x(static_cast<long long>(k_fold128High),
+							   static_cast<long long>(k_fold128Low));
+
+			// The incoming CRC lines up with the first 64 bits of data
+			__m128i x[4]{
+				_mm_xor_si128(LoadBlock(data),
+							  _mm_set_epi64x(static_cast<long long>(crc), 0)),
+				LoadBlock(data + 16),
+				LoadBlock(data + 32),
+				LoadBlock(data + 48),
+			};
+			data += 64;
+			size -= 64;
+			for (; size >= 64; data += 64, size -= 64)
+			{
+				for (int i = 0; i < 4; i++)
+				{
+					x[i] = _mm_xor_si128(Fold(x[i], fold512),
+										 LoadBlock(data + 16 * i));
+				}
+			}
+			auto r = x[0];
+			for (int i = 1; i < 4; i++)
+				r = _mm_xor_si128(Fold(r, fold128), x[i]);
+			for (; size >= 16; data += 16, size -= 16)
+				r = _mm_xor_si128(Fold(r, fold128), LoadBlock(data));
+
+			const auto reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+											  10, 11, 12, 13, 14, 15);
+			alignas(16) oxyU8 folded[16];
+			_mm_store_si128(reinterpret_cast<__m128i*>(folded),
+							_mm_shuffle_epi8(r, reverse));
+			crc = UpdateSlicing16(0, folded, sizeof folded);
+			return UpdateSlicing8(crc, data, size);
+		}
+#endif
+
+		using UpdateKernel = auto (*)(oxyU64, const oxyU8*, oxySize)
+			-> oxyU64;
+
+		auto GetKernel(CRC64Impl impl) -> UpdateKernel
+		{
+			switch (impl)
+			{
+			case CRC64Impl_Slicing8:
+				return &UpdateSlicing8;
+			case CRC64Impl_Slicing16:
+				return &UpdateSlicing16;
+			case CRC64Impl_Clmul:
+#ifdef OXYHASHCLMUL
+				if (GetCpuFeatures().m_pclmul && GetCpuFeatures().m_sse41)
+					return &UpdateClmul;
+#endif
+				return nullptr;
+			default:
+				return &UpdateTable;
+			}
+		}
+
+		auto SelectKernel() -> UpdateKernel
+		{
+			const auto clmul = GetKernel(CRC64Impl_Clmul);
+			return clmul ? clmul : &UpdateSlicing16;
+		}
+	}; // namespace
+
+	auto CRC64Update(oxyU64 crc, const oxyU8* data, oxySize size) -> oxyU64
+	{
+		static const UpdateKernel kernel = SelectKernel();
+		return kernel(crc, data, size);
+	}
+
+	auto CRC64UpdateWith(CRC64Impl impl, oxyU64 crc, const oxyU8* data,
+						 oxySize size) -> oxyU64
+	{
+		const auto kernel = GetKernel(impl);
+		return kernel ? kernel(crc, data, size) : UpdateTable(crc, data, size);
+	}
+
+	auto IsCRC64ImplSupported(CRC64Impl impl) -> oxyBool
+	{
+		return GetKernel(impl) != nullptr;
+	}
+
+	auto GetCRC64ImplName(CRC64Impl impl) -> std::string_view
+	{
+		switch (impl)
+		{
+		case CRC64Impl_Table:
+			return "table";
+		case CRC64Impl_Slicing8:
+			return "slicing8";
+		case CRC64Impl_Slicing16:
+			return "slicing16";
+		case CRC64Impl_Clmul:
+			return "clmul";
+		default:
+			return {};
+		}
+	}
+
+	auto CRC64Hasher::Update(std::span<const oxyU8> data) -> void
+	{
+		m_crc = CRC64Update(m_crc, data.data(), data.size());
+		m_size += data.size();
+	}
+
+	auto CRC64Hasher::Finalize() const -> oxyU64
+	{
+		return m_crc;
+	}
+
+	auto CRC64Hasher::GetSize() const -> oxyU64
+	{
+		return m_size;
+	}
+
+	auto CRC64Hasher::Reset() -> void
+	{
+		m_crc = 0;
+		m_size = 0;
+	}
+
+	auto CRC64Combine(oxyU64 crcA, oxyU64 crcB, oxyU64 sizeB) -> oxyU64
+	{
+		// Without an initial value or final XOR the CRC is linear, so
+		// appending b shifts crcA by sizeB bytes and adds crcB
+		for (oxySize k = 0; sizeB; k++, sizeB >>= 1)
+		{
+			if (sizeB & 1)
+				crcA = MultiplyModP(crcA, k_byteShifts[k]);
+		}
+		return crcA ^ crcB;
+	}
+}; // namespace oxygen
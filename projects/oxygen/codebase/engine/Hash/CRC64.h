@@ -102,4 +102,80 @@ namespace oxygen
 		}
 		return crc;
 	}
+	/**
+	 * @brief Same result as the byte overload. Characters need no
+	 * reinterpret_cast, so this one also works in consteval code.
+	 */
+	inline constexpr auto CRC64Eval(std::string_view text) -> oxyU64
+	{
+		oxyU64 crc{};
+		for (const auto c : text)
+		{
+			const auto t = (crc >> 0x38) ^ static_cast<oxyU8>(c);
+			crc = g_CRC64Table[t & 0xff] ^ (crc << 8);
+		}
+		return crc;
+	}
+
+	/**
+	 * @brief Run time CRC64 implementations, fastest last.
+	 */
+	enum CRC64Impl : oxyU8
+	{
+		// CRC64Eval's byte at a time table walk
+		CRC64Impl_Table,
+		// Eight or sixteen bytes per step through eight or sixteen tables
+		CRC64Impl_Slicing8,
+		CRC64Impl_Slicing16,
+		// Carry-less multiply folding, x86 with PCLMULQDQ only
+		CRC64Impl_Clmul,
+		CRC64Impl_Count,
+	};
+
+	/**
+	 * @brief Continues a CRC64 over more data, so that
+	 * CRC64Update(CRC64Eval(a), b) == CRC64Eval(a followed by b). Same
+	 * results as CRC64Eval, many times faster for run time data such as
+	 * file contents. Compile time ids keep using CRC64Eval.
+	 * @param crc The CRC64 of the preceding data, 0 to start
+	 */
+	auto CRC64Update(oxyU64 crc, const oxyU8* data, oxySize size) -> oxyU64;
+
+	/**
+	 * @brief CRC64Update through a given implementation, for comparing them.
+	 * Unsupported implementations fall back to CRC64Impl_Table.
+	 */
+	auto CRC64UpdateWith(CRC64Impl impl, oxyU64 crc, const oxyU8* data,
+						 oxySize size) -> oxyU64;
+	auto IsCRC64ImplSupported(CRC64Impl impl) -> oxyBool;
+	auto GetCRC64ImplName(CRC64Impl impl) -> std::string_view;
+
+	/**
+	 * @brief CRC64 of data that arrives in pieces, such as a file read in
+	 * blocks. Finalize() equals CRC64Eval over everything passed to Update().
+	 */
+	struct CRC64Hasher
+	{
+		auto Update(std::span<const oxyU8> data) -> void;
+		/**
+		 * @brief Leaves the state untouched, more data may follow.
+		 */
+		auto Finalize() const -> oxyU64;
+		/**
+		 * @brief Bytes hashed so far, the size CRC64Combine needs.
+		 */
+		auto GetSize() const -> oxyU64;
+		auto Reset() -> void;
+
+	  private:
+		oxyU64 m_crc{};
+		oxyU64 m_size{};
+	};
+
+	/**
+	 * @brief CRC64 of a followed by b from the CRC64s of the two parts, in
+	 * O(log sizeB) time. Lets chunks hashed on different threads be merged
+	 * into the CRC64 of the whole.
+	 */
+	auto CRC64Combine(oxyU64 crcA, oxyU64 crcB, oxyU64 sizeB) -> oxyU64;
 };
\ No newline at end of file
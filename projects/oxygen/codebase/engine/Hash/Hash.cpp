@@ -0,0 +1,91 @@
+#include "OxygenPCH.h"
+
+#include <cstring>
+
+namespace oxygen
+{
+	namespace
+	{
+		constexpr oxyU64 k_secret[4]{
+			0x2d358dccaa6c78a5ULL,
+			0x8bb84b93962eacc9ULL,
+			0x4b33a62ed433d4a3ULL,
+			0x4d5a2da51de1aa47ULL,
+		};
+
+		inline auto Mix(oxyU64 a, oxyU64 b) -> oxyU64
+		{
+			HashImpl::Multiply(a, b);
+			return a ^ b;
+		}
+
+		inline auto Read8(const oxyU8* p) -> oxyU64
+		{
+			oxyU64 v;
+			std::memcpy(&v, p, sizeof v);
+			return v;
+		}
+		inline auto Read4(const oxyU8* p) -> oxyU64
+		{
+			oxyU32 v;
+			std::memcpy(&v, p, sizeof v);
+			return v;
+		}
+		/**
+		 * @brief First, middle and last byte of 1 to 3 bytes.
+		 */
+		inline auto Read3(const oxyU8* p, oxySize size) -> oxyU64
+		{
+			return (oxyU64{p[0]} << 16) | (oxyU64{p[size >> 1]} << 8) |
+				   p[size - 1];
+		}
+	}; // namespace
+
+	auto HashBytes(const void* data, oxySize size, oxyU64 seed) -> oxyU64
+	{
+		const auto* p = static_cast<const oxyU8*>(data);
+		seed ^= Mix(seed ^ k_secret[0], k_secret[1]);
+		oxyU64 a{}, b{};
+		if (size <= 16)
+		{
+			// Two overlapping reads cover 4 to 16 bytes without a loop
+			if (size >= 4)
+			{
+				const auto middle = (size >> 3) << 2;
+				a = (Read4(p) << 32) | Read4(p + middle);
+				b = (Read4(p + size - 4) << 32) | Read4(p + size - 4 - middle);
+			}
+			else if (size > 0)
+				a = Read3(p, size);
+		}
+		else
+		{
+			auto rest = size;
+			if (rest > 48)
+			{
+				// Three independent lanes keep the multipliers busy
+				auto lane1 = seed, lane2 = seed;
+				do
+				{
+					seed = Mix(Read8(p) ^ k_secret[1], Read8(p + 8) ^ seed);
+					lane1 = Mix(Read8(p + 16) ^ k_secret[2],
+								Read8(p + 24) ^ lane1);
+					lane2 = Mix(Read8(p + 32) ^ k_secret[3],
+								Read8(p + 40) ^ lane2);
+					p += 48;
+					rest -= 48;
+				} while (rest > 48);
+				seed ^= lane1 ^ lane2;
+			}
+			for (; rest > 16; p += 16, rest -= 16)
+				seed = Mix(Read8(p) ^ k_secret[1], Read8(p + 8) ^ seed);
+			// The last 16 bytes, overlapping what was already mixed
+			a = Read8(p + rest - 16);
+			b = Read8(p + rest - 8);
+		}
+		a ^= k_secret[1];
+		b ^= seed;
+		HashImpl::Multiply(a, b);
+		return Mix(a ^ k_secret[0] ^ size, b ^ k_secret[1]);
+	}
+}; // namespace oxygen
@@ -0,0 +1,112 @@
+#pragma once
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace oxygen
+{
+	namespace HashImpl
+	{
+		/**
+		 * @brief Full 128 bit product of a and b, low half in a and high
+		 * half in b.
+		 */
+		constexpr auto Multiply(oxyU64& a, oxyU64& b) -> void
+		{
+#if defined(__SIZEOF_INT128__)
+			const auto r = static_cast<unsigned __int128>(a) * b;
+			a = static_cast<oxyU64>(r);
+			b = static_cast<oxyU64>(r >> 64);
+#else
+#if defined(_MSC_VER) && defined(_M_X64)
+			if (!std::is_constant_evaluated())
+			{
+				a = _umul128(a, b, &b);
+				return;
+			}
+#endif
+			const auto aHigh = a >> 32, aLow = a & 0xffffffff;
+			const auto bHigh = b >> 32, bLow = b & 0xffffffff;
+			const auto hh = aHigh * bHigh, hl = aHigh * bLow;
+			const auto lh = aLow * bHigh, ll = aLow * bLow;
+			const auto t = hl + (ll >> 32);
+			const auto u = lh + (t & 0xffffffff);
+			a = (u << 32) | (ll & 0xffffffff);
+			b = hh + (t >> 32) + (u >> 32);
+#endif
+		}
+	}; // namespace HashImpl
+
+	/**
+	 * @brief One 64x64 to 128 bit multiply by 2^64 / phi with the two
+	 * halves folded together, so every bit of v reaches the low bits a
+	 * power of two table masks. Keys that only differ in a few bits, like
+	 * sequential ids or aligned pointers, spread over all buckets.
+	 */
+	constexpr auto HashInt(oxyU64 v) -> oxyU64
+	{
+		oxyU64 high = 0x9e3779b97f4a7c15ULL;
+		HashImpl::Multiply(v, high);
+		return v ^ high;
+	}
+
+	inline auto HashPointer(const void* ptr) -> oxyU64
+	{
+		return HashInt(reinterpret_cast<std::uintptr_t>(ptr));
+	}
+
+	/**
+	 * @brief Hash of size bytes in the style of wyhash, a few multiplies
+	 * per 16 bytes and no tables. Only meant for in-memory hash tables:
+	 * the result may change between versions and platforms, so anything
+	 * stored or sent over the network uses CRC64 instead.
+	 */
+	auto HashBytes(const void* data, oxySize size, oxyU64 seed = 0)
+		-> oxyU64;
+
+	inline auto HashString(std::string_view text, oxyU64 seed = 0) -> oxyU64
+	{
+		return HashBytes(text.data(), text.size(), seed);
+	}
+
+	/**
+	 * @brief Hash functor for the engine's unordered containers, used in
+	 * place of std::hash. Like std::hash, a char pointer is hashed as a
+	 * pointer, not as the text it points to.
+	 */
+	struct Hasher
+	{
+		template <typename T>
+			requires std::is_integral_v<T> || std::is_enum_v<T>
+		auto operator()(T value) const noexcept -> size_t
+		{
+			return static_cast<size_t>(HashInt(static_cast<oxyU64>(value)));
+		}
+		template <typename T> auto operator()(T* ptr) const noexcept -> size_t
+		{
+			if constexpr (std::is_function_v<T>)
+			{
+				return static_cast<size_t>(
+					HashInt(reinterpret_cast<std::uintptr_t>(ptr)));
+			}
+			else
+				return static_cast<size_t>(HashPointer(ptr));
+		}
+		auto operator()(std::string_view text) const noexcept -> size_t
+		{
+			return static_cast<size_t>(HashString(text));
+		}
+		auto operator()(const std::string& text) const noexcept -> size_t
+		{
+			return static_cast<size_t>(HashString(text));
+		}
+		/**
+		 * @brief The id is already a CRC64 of the name, well spread.
+		 */
+		auto operator()(StringID id) const noexcept -> size_t
+		{
+			return static_cast<size_t>(id.GetID());
+		}
+	};
+}; // namespace oxygen
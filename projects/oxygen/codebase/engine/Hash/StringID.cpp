@@ -0,0 +1,69 @@
+#include "OxygenPCH.h"
+
+#include <mutex>
+
+namespace oxygen
+{
+#ifdef OXYDEBUG
+	namespace
+	{
+		/**
+		 * @brief Names by id. Map nodes never move, so views of the stored
+		 * names stay valid.
+		 */
+		struct StringIDTable
+		{
+			std::mutex m_mutex{};
+			std::unordered_map<oxyU64, std::string, Hasher> m_names{};
+		};
+
+		auto GetStringIDTable() -> StringIDTable&
+		{
+			static StringIDTable table{};
+			return table;
+		}
+	}; // namespace
+#endif
+
+	auto StringID::FromString(std::string_view name) -> StringID
+	{
+		const auto id = CRC64Eval(name);
+		RegisterStringID(id, name);
+		return FromID(id);
+	}
+
+	auto StringID::GetName() const -> std::string_view
+	{
+		return FindStringIDName(m_id);
+	}
+
+	auto RegisterStringID(oxyU64 id, std::string_view name) -> oxyBool
+	{
+#ifdef OXYDEBUG
+		auto& table = GetStringIDTable();
+		std::lock_guard lock{table.m_mutex};
+		const auto [it, inserted] = table.m_names.try_emplace(id, name);
+		// Two different names hashing to the same id
+		OXYCHECK(inserted || it->second == name);
+		return inserted || it->second == name;
+#else
+		static_cast<void>(id);
+		static_cast<void>(name);
+		return true;
+#endif
+	}
+
+	auto FindStringIDName(oxyU64 id) -> std::string_view
+	{
+#ifdef OXYDEBUG
+		auto& table = GetStringIDTable();
+		std::lock_guard lock{table.m_mutex};
+		const auto it = table.m_names.find(id);
+		if (it != table.m_names.end())
+			return it->second;
+#else
+		static_cast<void>(id);
+#endif
+		return {};
+	}
+}; // namespace oxygen
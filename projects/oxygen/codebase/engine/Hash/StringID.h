@@ -0,0 +1,114 @@
+#pragma once
+
+namespace oxygen
+{
+	/**
+	 * @brief Identity of a name, its CRC64. Comparing and hashing cost one
+	 * integer operation, so hot paths never compare strings. Literals are
+	 * hashed at compile time with "name"_sid, names only known at run time
+	 * with FromString(). Debug builds record every name, which catches two
+	 * names sharing an id and lets tools turn ids back into names.
+	 */
+	struct StringID
+	{
+		constexpr StringID() = default;
+
+		/**
+		 * @brief Hashes a run time name, such as an asset path.
+		 */
+		static auto FromString(std::string_view name) -> StringID;
+		/**
+		 * @brief Wraps an id computed elsewhere, e.g. read from a file.
+		 */
+		static constexpr auto FromID(oxyU64 id) -> StringID
+		{
+			StringID result{};
+			result.m_id = id;
+			return result;
+		}
+
+		constexpr auto GetID() const -> oxyU64
+		{
+			return m_id;
+		}
+		/**
+		 * @brief The empty name hashes to 0, which is also the default.
+		 */
+		constexpr auto IsValid() const -> oxyBool
+		{
+			return m_id != 0;
+		}
+		/**
+		 * @brief Name recorded for this id in debug builds. Empty in release
+		 * builds and for ids never created from a name.
+		 */
+		auto GetName() const -> std::string_view;
+
+		constexpr auto operator==(const StringID& other) const -> bool
+		{
+			return m_id == other.m_id;
+		}
+
+	  private:
+		oxyU64 m_id{};
+	};
+
+	/**
+	 * @brief Records name for id in debug builds, does nothing otherwise.
+	 * @return False if a different name was already recorded for id
+	 */
+	auto RegisterStringID(oxyU64 id, std::string_view name) -> oxyBool;
+	/**
+	 * @brief Name recorded for id, empty if none or in release builds.
+	 */
+	auto FindStringIDName(oxyU64 id) -> std::string_view;
+
+	/**
+	 * @brief A string literal as a template argument, see operator""_sid.
+	 */
+	template <oxySize N> struct StringIDLiteral
+	{
+		oxyChar m_text[N]{};
+
+		consteval StringIDLiteral(const oxyChar (&text)[N])
+		{
+			for (oxySize i = 0; i < N; i++)
+				m_text[i] = text[i];
+		}
+		constexpr auto View() const -> std::string_view
+		{
+			return {m_text, N - 1};
+		}
+	};
+
+	/**
+	 * @brief Records a literal's name once at startup, instantiated by
+	 * operator""_sid in debug builds.
+	 */
+	template <StringIDLiteral Name> struct StringIDRegistration
+	{
+		static inline const oxyBool g_registered =
+			RegisterStringID(CRC64Eval(Name.View()), Name.View());
+	};
+
+	/**
+	 * @brief StringID of a literal, computed at compile time:
+	 * "Player"_sid. Macros pass stringized names as
+	 * ::oxygen::operator""_sid<#Name>().
+	 */
+	template <StringIDLiteral Name> consteval auto operator""_sid() -> StringID
+	{
+#ifdef OXYDEBUG
+		static_cast<void>(&StringIDRegistration<Name>::g_registered);
+#endif
+		return StringID::FromID(CRC64Eval(Name.View()));
+	}
+}; // namespace oxygen
+
+template <> struct std::hash<oxygen::StringID>
+{
+	auto operator()(const oxygen::StringID& id) const noexcept -> size_t
+	{
+		return static_cast<size_t>(id.GetID());
+	}
+};
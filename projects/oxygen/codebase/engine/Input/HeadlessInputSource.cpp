@@ -0,0 +1,421 @@
+#include "OxygenPCH.h"
+#include "HeadlessInputSource.h"
+#include "InputManager.h"
+
+#include "Filesystem/Filesystem.h"
+
+#include <charconv>
+
+namespace oxygen
+{
+	namespace
+	{
+		// Script command per InputSampleType
+		constexpr std::string_view k_commandNames[InputSampleType_Count]{
+			"key", "mousebutton", "mousemove", "connect", "button", "axis",
+		};
+
+		auto NextToken(std::string_view& line) -> std::string_view
+		{
+			const auto start = line.find_first_not_of(" \t\r");
+			if (start == std::string_view::npos)
+			{
+				line = {};
+				return {};
+			}
+			line.remove_prefix(start);
+			const auto end = std::min(line.find_first_of(" \t\r"), line.size());
+			const auto token = line.substr(0, end);
+			line.remove_prefix(end);
+			return token;
+		}
+
+		template <typename T>
+		auto ParseToken(std::string_view& line, T& value) -> oxyBool
+		{
+			const auto token = NextToken(line);
+			if (token.empty())
+				return false;
+			const auto tokenEnd = token.data() + token.size();
+			const auto result = std::from_chars(token.data(), tokenEnd, value);
+			return result.ec == std::errc{} && result.ptr == tokenEnd;
+		}
+
+		template <typename T>
+		auto ParseIndex(std::string_view& line, oxyU8& value, T count)
+			-> oxyBool
+		{
+			return ParseToken(line, value) && value < count;
+		}
+
+		auto ParseEntry(std::string_view line, oxyU64& frame,
+						InputSample& sample) -> oxyBool
+		{
+			if (!ParseToken(line, frame))
+				return false;
+			const auto command = NextToken(line);
+			const auto it = std::ranges::find(k_commandNames, command);
+			if (it == std::end(k_commandNames))
+				return false;
+			sample = {};
+			sample.m_type = static_cast<InputSampleType>(
+				std::distance(std::begin(k_commandNames), it));
+
+			oxyU8 isDown{};
+			oxyBool isValid{};
+			switch (sample.m_type)
+			{
+			case InputSampleType_KeyboardButton:
+				isValid =
+					ParseIndex(line, sample.m_index, KeyboardButton_Count) &&
+					ParseToken(line, isDown);
+				break;
+			case InputSampleType_MouseButton:
+				isValid =
+					ParseIndex(line, sample.m_index, MouseButton_Count) &&
+					ParseToken(line, isDown);
+				break;
+			case InputSampleType_MouseMoved:
+				isValid = ParseToken(line, sample.m_x) &&
+						  ParseToken(line, sample.m_y);
+				break;
+			case InputSampleType_ControllerConnection:
+				isValid = ParseIndex(line, sample.m_controllerIndex,
+									 OXYGENMAXCONTROLLERS) &&
+						  ParseToken(line, isDown);
+				break;
+			case InputSampleType_ControllerButton:
+				isValid = ParseIndex(line, sample.m_controllerIndex,
+									 OXYGENMAXCONTROLLERS) &&
+						  ParseIndex(line, sample.m_index,
+									 ControllerButton_Count) &&
+						  ParseToken(line, isDown);
+				break;
+			case InputSampleType_ControllerAxis:
+				isValid = ParseIndex(line, sample.m_controllerIndex,
+									 OXYGENMAXCONTROLLERS) &&
+						  ParseIndex(line, sample.m_index,
+									 ControllerAxis_Count) &&
+						  ParseToken(line, sample.m_x);
+				break;
+			default:
+				break;
+			}
+			sample.m_isDown = isDown != 0;
+			return isValid && isDown <= 1 && NextToken(line).empty();
+		}
+
+		auto AppendEntry(std::string& out, oxyU64 frame,
+						 const InputSample& sample) -> void
+		{
+			char line[128]{};
+			const auto command = k_commandNames[sample.m_type];
+			const auto length = static_cast<oxyS32>(command.size());
+			switch (sample.m_type)
+			{
+			case InputSampleType_KeyboardButton:
+			case InputSampleType_MouseButton:
+				std::snprintf(line, sizeof(line), "%llu %.*s %u %u\n",
+							  static_cast<unsigned long long>(frame), length,
+							  command.data(), sample.m_index, sample.m_isDown);
+				break;
+			case InputSampleType_MouseMoved:
+				std::snprintf(line, sizeof(line), "%llu %.*s %g %g\n",
+							  static_cast<unsigned long long>(frame), length,
+							  command.data(), sample.m_x, sample.m_y);
+				break;
+			case InputSampleType_ControllerConnection:
+				std::snprintf(line, sizeof(line), "%llu %.*s %u %u\n",
+							  static_cast<unsigned long long>(frame), length,
+							  command.data(), sample.m_controllerIndex,
+							  sample.m_isDown);
+				break;
+			case InputSampleType_ControllerButton:
+				std::snprintf(line, sizeof(line), "%llu %.*s %u %u %u\n",
+							  static_cast<unsigned long long>(frame), length,
+							  command.data(), sample.m_controllerIndex,
+							  sample.m_index, sample.m_isDown);
+				break;
+			case InputSampleType_ControllerAxis:
+				// %.9g round-trips every float exactly
+				std::snprintf(line, sizeof(line), "%llu %.*s %u %u %.9g\n",
+							  static_cast<unsigned long long>(frame), length,
+							  command.data(), sample.m_controllerIndex,
+							  sample.m_index, sample.m_x);
+				break;
+			default:
+				OXYCHECK(false);
+				return;
+			}
+			out += line;
+		}
+	}; // namespace
+
+	auto HeadlessInputSource::LoadScript(std::string_view script) -> oxyBool
+	{
+		std::vector<ScriptEntry> entries{};
+		while (!script.empty())
+		{
+			const auto end = std::min(script.find('\n'), script.size());
+			auto line = script.substr(0, end);
+			script.remove_prefix(std::min(end + 1, script.size()));
+
+			line = line.substr(0, std::min(line.find('#'), line.size()));
+			if (line.find_first_not_of(" \t\r") == std::string_view::npos)
+				continue;
+			ScriptEntry entry{};
+			if (!ParseEntry(line, entry.m_frame, entry.m_sample))
+				return false;
+			if (!entries.empty() && entry.m_frame < entries.back().m_frame)
+				return false;
+			entries.push_back(entry);
+		}
+		Reset();
+		m_script = std::move(entries);
+		return true;
+	}
+
+	auto HeadlessInputSource::LoadScriptFile(std::string_view path) -> oxyBool
+	{
+		const auto data = Filesystem::GetInstance().ReadFile(path);
+		if (data.empty())
+			return false;
+		return LoadScript({reinterpret_cast<const char*>(data.data()),
+						   data.size()});
+	}
+
+	auto HeadlessInputSource::SetRandom(
+		oxyU64 seed, const HeadlessInputRandomSettings& settings) -> void
+	{
+		OXYCHECK(settings.m_controllerCount >= 0 &&
+				 settings.m_controllerCount <= OXYGENMAXCONTROLLERS);
+		Reset();
+		m_isRandom = true;
+		m_randomState = seed;
+		m_randomSettings = settings;
+		for (oxyS32 i = 0; i < settings.m_controllerCount; ++i)
+			m_controllers[i].m_connected = true;
+	}
+
+	auto HeadlessInputSource::Update(InputManager& input) -> oxyBool
+	{
+		if (m_isRandom)
+			UpdateRandom();
+		for (; m_scriptPosition < m_script.size() &&
+			   m_script[m_scriptPosition].m_frame <= m_frame;
+			 ++m_scriptPosition)
+			Apply(m_script[m_scriptPosition].m_sample);
+		++m_frame;
+
+		input.UpdateKeyboard(m_keyboard);
+		input.UpdateMouse(m_mouse);
+		for (oxyS32 i = 0; i < OXYGENMAXCONTROLLERS; ++i)
+			input.UpdateController(i, m_controllers[i]);
+		return m_isRandom || m_scriptPosition < m_script.size();
+	}
+
+	auto HeadlessInputSource::GetFrame() const -> oxyU64
+	{
+		return m_frame;
+	}
+
+	auto HeadlessInputSource::Record(const InputManager& input) -> void
+	{
+		InputSample sample{};
+		for (oxyU8 i = 0; i < KeyboardButton_Count; ++i)
+		{
+			const auto isDown = input.IsKeyDown(static_cast<KeyboardButton>(i));
+			if (isDown == m_recordedKeyboard.m_keys.Test(i))
+				continue;
+			m_recordedKeyboard.m_keys.Set(i, isDown);
+			sample = {};
+			sample.m_type = InputSampleType_KeyboardButton;
+			sample.m_index = i;
+			sample.m_isDown = isDown;
+			AppendEntry(m_recording, m_recordFrame, sample);
+		}
+		for (oxyU8 i = 0; i < MouseButton_Count; ++i)
+		{
+			const auto isDown =
+				input.IsMouseButtonDown(static_cast<MouseButton>(i));
+			if (isDown == m_recordedMouse.m_buttons.Test(i))
+				continue;
+			m_recordedMouse.m_buttons.Set(i, isDown);
+			sample = {};
+			sample.m_type = InputSampleType_MouseButton;
+			sample.m_index = i;
+			sample.m_isDown = isDown;
+			AppendEntry(m_recording, m_recordFrame, sample);
+		}
+		{
+			oxyS32 x{};
+			oxyS32 y{};
+			input.GetMousePosition(x, y);
+			if (static_cast<oxyF32>(x) != m_recordedMouse.m_x ||
+				static_cast<oxyF32>(y) != m_recordedMouse.m_y)
+			{
+				m_recordedMouse.m_x = static_cast<oxyF32>(x);
+				m_recordedMouse.m_y = static_cast<oxyF32>(y);
+				sample = {};
+				sample.m_type = InputSampleType_MouseMoved;
+				sample.m_x = m_recordedMouse.m_x;
+				sample.m_y = m_recordedMouse.m_y;
+				AppendEntry(m_recording, m_recordFrame, sample);
+			}
+		}
+		for (oxyU8 c = 0; c < OXYGENMAXCONTROLLERS; ++c)
+		{
+			auto& controller = m_recordedControllers[c];
+			const auto isConnected = input.IsControllerConnected(c);
+			if (isConnected != controller.m_connected)
+			{
+				controller.m_connected = isConnected;
+				sample = {};
+				sample.m_type = InputSampleType_ControllerConnection;
+				sample.m_controllerIndex = c;
+				sample.m_isDown = isConnected;
+				AppendEntry(m_recording, m_recordFrame, sample);
+			}
+			for (oxyU8 i = 0; i < ControllerButton_Count; ++i)
+			{
+				const auto isDown = input.IsControllerButtonDown(
+					c, static_cast<ControllerButton>(i));
+				if (isDown == controller.m_buttonValues.Test(i))
+					continue;
+				controller.m_buttonValues.Set(i, isDown);
+				sample = {};
+				sample.m_type = InputSampleType_ControllerButton;
+				sample.m_controllerIndex = c;
+				sample.m_index = i;
+				sample.m_isDown = isDown;
+				AppendEntry(m_recording, m_recordFrame, sample);
+			}
+			// Unfiltered, so playback goes through the same filtering
+			for (oxyU8 i = 0; i < ControllerAxis_Count; ++i)
+			{
+				const auto value = input.GetRawControllerAxisValue(
+					c, static_cast<ControllerAxis>(i));
+				if (value == controller.m_axisValues[i])
+					continue;
+				controller.m_axisValues[i] = value;
+				sample = {};
+				sample.m_type = InputSampleType_ControllerAxis;
+				sample.m_controllerIndex = c;
+				sample.m_index = i;
+				sample.m_x = value;
+				AppendEntry(m_recording, m_recordFrame, sample);
+			}
+		}
+		++m_recordFrame;
+	}
+
+	auto HeadlessInputSource::GetRecording() const -> const std::string&
+	{
+		return m_recording;
+	}
+
+	auto HeadlessInputSource::Reset() -> void
+	{
+		m_script.clear();
+		m_scriptPosition = 0;
+		m_isRandom = false;
+		std::ranges::fill(&m_axisTargets[0][0],
+						  &m_axisTargets[0][0] +
+							  OXYGENMAXCONTROLLERS * ControllerAxis_Count,
+						  0.0f);
+		m_frame = 0;
+		m_keyboard = {};
+		m_mouse = {};
+		std::ranges::fill(m_controllers, ControllerInputState{});
+	}
+
+	auto HeadlessInputSource::Apply(const InputSample& sample) -> void
+	{
+		auto& controller = m_controllers[sample.m_controllerIndex];
+		switch (sample.m_type)
+		{
+		case InputSampleType_KeyboardButton:
+			m_keyboard.m_keys.Set(sample.m_index, sample.m_isDown);
+			break;
+		case InputSampleType_MouseButton:
+			m_mouse.m_buttons.Set(sample.m_index, sample.m_isDown);
+			break;
+		case InputSampleType_MouseMoved:
+			m_mouse.m_x = sample.m_x;
+			m_mouse.m_y = sample.m_y;
+			break;
+		case InputSampleType_ControllerConnection:
+			controller.m_connected = sample.m_isDown;
+			break;
+		case InputSampleType_ControllerButton:
+			controller.m_buttonValues.Set(sample.m_index, sample.m_isDown);
+			break;
+		case InputSampleType_ControllerAxis:
+			controller.m_axisValues[sample.m_index] = sample.m_x;
+			break;
+		default:
+			OXYCHECK(false);
+			break;
+		}
+	}
+
+	auto HeadlessInputSource::UpdateRandom() -> void
+	{
+		const auto& settings = m_randomSettings;
+		if (NextRandomFloat() < settings.m_keyToggleChance)
+		{
+			const auto key = NextRandom() % KeyboardButton_Count;
+			m_keyboard.m_keys.Set(key, !m_keyboard.m_keys.Test(key));
+		}
+		if (NextRandomFloat() < settings.m_mouseButtonToggleChance)
+		{
+			const auto button = NextRandom() % MouseButton_Count;
+			m_mouse.m_buttons.Set(button, !m_mouse.m_buttons.Test(button));
+		}
+		m_mouse.m_x += std::round((NextRandomFloat() * 2.0f - 1.0f) *
+								  settings.m_mouseMaxStep);
+		m_mouse.m_y += std::round((NextRandomFloat() * 2.0f - 1.0f) *
+								  settings.m_mouseMaxStep);
+
+		for (oxyS32 c = 0; c < settings.m_controllerCount; ++c)
+		{
+			auto& controller = m_controllers[c];
+			if (NextRandomFloat() < settings.m_controllerButtonToggleChance)
+			{
+				const auto button = NextRandom() % ControllerButton_Count;
+				controller.m_buttonValues.Set(
+					button, !controller.m_buttonValues.Test(button));
+			}
+			for (oxyU8 i = 0; i < ControllerAxis_Count; ++i)
+			{
+				const auto isTrigger = i >= ControllerAxis_LeftTrigger;
+				auto& target = m_axisTargets[c][i];
+				if (NextRandomFloat() < settings.m_axisMoveChance)
+				{
+					target = NextRandomFloat();
+					if (!isTrigger)
+						target = target * 2.0f - 1.0f;
+				}
+				const auto noise =
+					(NextRandomFloat() * 2.0f - 1.0f) * settings.m_axisNoise;
+				controller.m_axisValues[i] =
+					std::clamp(target + noise, isTrigger ? 0.0f : -1.0f, 1.0f);
+			}
+		}
+	}
+
+	auto HeadlessInputSource::NextRandom() -> oxyU64
+	{
+		// SplitMix64, identical output on every platform and compiler
+		auto z = (m_randomState += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	auto HeadlessInputSource::NextRandomFloat() -> oxyF32
+	{
+		// Top 24 bits, exactly representable in [0, 1)
+		return static_cast<oxyF32>(NextRandom() >> 40) * 0x1.0p-24f;
+	}
+}; // namespace oxygen
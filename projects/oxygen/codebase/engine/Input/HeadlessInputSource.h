@@ -0,0 +1,103 @@
+#pragma once
+
+#include "InputSampleBuffer.h"
+
+namespace oxygen
+{
+	struct InputManager;
+
+	/**
+	 * @brief Tuning for HeadlessInputSource::SetRandom.
+	 */
+	struct HeadlessInputRandomSettings
+	{
+		// Chance per frame to toggle one random key or button
+		oxyF32 m_keyToggleChance{0.05f};
+		oxyF32 m_mouseButtonToggleChance{0.02f};
+		oxyF32 m_controllerButtonToggleChance{0.02f};
+		// Mouse moves up to this many pixels per axis per frame
+		oxyF32 m_mouseMaxStep{8.0f};
+		// Chance per frame for an axis to move to a new position
+		oxyF32 m_axisMoveChance{0.02f};
+		// Noise added to every axis every frame, as on a real stick
+		oxyF32 m_axisNoise{0.05f};
+		oxyS32 m_controllerCount{1};
+	};
+
+	/**
+	 * @brief Feeds InputManager without a window, from a script, a recording
+	 * or a deterministic pseudo-random generator. Used to run the input path
+	 * on machines without a platform message loop, see RunHeadlessMode.
+	 *
+	 * Scripts are text with one change per line, '#' starts a comment:
+	 *   <frame> key <KeyboardButton> <0|1>
+	 *   <frame> mousebutton <MouseButton> <0|1>
+	 *   <frame> mousemove <x> <y>
+	 *   <frame> connect <controller> <0|1>
+	 *   <frame> button <controller> <ControllerButton> <0|1>
+	 *   <frame> axis <controller> <ControllerAxis> <value>
+	 * Enum values are written as numbers, frames must not decrease.
+	 */
+	struct HeadlessInputSource : NonCopyable
+	{
+		/**
+		 * @brief Replaces the current source with a script.
+		 * @return False if a line could not be parsed, nothing is loaded then.
+		 */
+		auto LoadScript(std::string_view script) -> oxyBool;
+		auto LoadScriptFile(std::string_view path) -> oxyBool;
+		/**
+		 * @brief Replaces the current source with a pseudo-random generator.
+		 * The same seed produces the same input on every platform.
+		 */
+		auto SetRandom(oxyU64 seed,
+					   const HeadlessInputRandomSettings& settings = {})
+			-> void;
+
+		/**
+		 * @brief Advances one frame and passes the resulting state to the
+		 * input manager. Call between BeginUpdate and EndUpdate.
+		 * @return False once a script has no more changes.
+		 */
+		auto Update(InputManager& input) -> oxyBool;
+		auto GetFrame() const -> oxyU64;
+
+		/**
+		 * @brief Appends the changes since the last call as script lines.
+		 * Call after EndUpdate to record a live session for later playback.
+		 */
+		auto Record(const InputManager& input) -> void;
+		auto GetRecording() const -> const std::string&;
+
+	  private:
+		struct ScriptEntry
+		{
+			oxyU64 m_frame{};
+			InputSample m_sample{};
+		};
+		std::vector<ScriptEntry> m_script{};
+		oxySize m_scriptPosition{};
+
+		oxyBool m_isRandom{};
+		oxyU64 m_randomState{};
+		HeadlessInputRandomSettings m_randomSettings{};
+		oxyF32 m_axisTargets[OXYGENMAXCONTROLLERS][ControllerAxis_Count]{};
+
+		oxyU64 m_frame{};
+		KeyboardInputState m_keyboard{};
+		MouseInputState m_mouse{};
+		ControllerInputState m_controllers[OXYGENMAXCONTROLLERS]{};
+
+		oxyU64 m_recordFrame{};
+		KeyboardInputState m_recordedKeyboard{};
+		MouseInputState m_recordedMouse{};
+		ControllerInputState m_recordedControllers[OXYGENMAXCONTROLLERS]{};
+		std::string m_recording{};
+
+		auto Reset() -> void;
+		auto Apply(const InputSample& sample) -> void;
+		auto UpdateRandom() -> void;
+		auto NextRandom() -> oxyU64;
+		auto NextRandomFloat() -> oxyF32;
+	};
+}; // namespace oxygen
@@ -0,0 +1,273 @@
+#include "OxygenPCH.h"
+#include "InputActionMap.h"
+#include "InputManager.h"
+
+#include "Events/EventManager.h"
+
+namespace oxygen
+{
+	namespace
+	{
+		// Every input that can be bound gets one slot index
+		constexpr oxyU16 k_keyboardSlotBase{0};
+		constexpr oxyU16 k_mouseSlotBase{k_keyboardSlotBase +
+										 KeyboardButton_Count};
+		constexpr oxyU16 k_controllerButtonSlotBase{k_mouseSlotBase +
+													MouseButton_Count};
+		constexpr oxyU16 k_controllerAxisSlotBase{
+			k_controllerButtonSlotBase +
+			OXYGENMAXCONTROLLERS * ControllerButton_Count};
+		constexpr oxyU16 k_slotCount{k_controllerAxisSlotBase +
+									 OXYGENMAXCONTROLLERS *
+										 ControllerAxis_Count};
+
+		auto GetSlot(InputBindingSource source, oxyU8 index,
+					 oxyS32 controllerIndex) -> oxyU16
+		{
+			switch (source)
+			{
+			case InputBindingSource_Keyboard:
+				return k_keyboardSlotBase + index;
+			case InputBindingSource_Mouse:
+				return k_mouseSlotBase + index;
+			case InputBindingSource_ControllerButton:
+				return k_controllerButtonSlotBase +
+					   controllerIndex * ControllerButton_Count + index;
+			case InputBindingSource_ControllerAxis:
+				return k_controllerAxisSlotBase +
+					   controllerIndex * ControllerAxis_Count + index;
+			default:
+				break;
+			}
+			OXYCHECK(false);
+			return 0;
+		}
+	}; // namespace
+
+	auto InputActionMap::AddAction(std::string_view name) -> oxyU32
+	{
+		const auto existing = FindAction(name);
+		if (existing != k_invalidAction)
+			return existing;
+		Action action{};
+		action.m_name = name;
+		action.m_id = StringID::FromString(name).GetID();
+		m_actions.push_back(std::move(action));
+		m_isCompiled = false;
+		return static_cast<oxyU32>(m_actions.size() - 1);
+	}
+
+	auto InputActionMap::FindAction(std::string_view name) const -> oxyU32
+	{
+		const auto id = CRC64Eval(name);
+		for (oxySize i = 0; i < m_actions.size(); ++i)
+		{
+			// The id only skips the string compare, two names may share a
+			// CRC64
+			if (m_actions[i].m_id == id && m_actions[i].m_name == name)
+				return static_cast<oxyU32>(i);
+		}
+		return k_invalidAction;
+	}
+
+	auto InputActionMap::GetActionName(oxyU32 action) const -> std::string_view
+	{
+		OXYCHECK(action < m_actions.size());
+		return m_actions[action].m_name;
+	}
+
+	auto InputActionMap::AddBinding(oxyU32 action, const InputBinding& binding)
+		-> void
+	{
+		OXYCHECK(action < m_actions.size());
+		OXYCHECK(binding.m_modifierCount <= InputBinding::k_maxModifiers);
+		m_actions[action].m_bindings.push_back(binding);
+		m_isCompiled = false;
+	}
+
+	auto InputActionMap::ClearBindings(oxyU32 action) -> void
+	{
+		OXYCHECK(action < m_actions.size());
+		m_actions[action].m_bindings.clear();
+		m_isCompiled = false;
+	}
+
+	auto InputActionMap::Compile() -> void
+	{
+		m_actionBindingOffsets.clear();
+		m_compiledBindings.clear();
+		// (slot, action) pairs, bucketed into m_slotActions below
+		std::vector<std::pair<oxyU16, oxyU32>> triggers{};
+		for (oxyU32 a = 0; a < m_actions.size(); ++a)
+		{
+			m_actionBindingOffsets.push_back(
+				static_cast<oxyU32>(m_compiledBindings.size()));
+			for (const auto& binding : m_actions[a].m_bindings)
+			{
+				const auto isControllerSource =
+					binding.m_source == InputBindingSource_ControllerButton ||
+					binding.m_source == InputBindingSource_ControllerAxis;
+				oxyS32 first = 0;
+				oxyS32 last = 0;
+				if (isControllerSource)
+				{
+					first = binding.m_controllerIndex < 0
+								? 0
+								: binding.m_controllerIndex;
+					last = binding.m_controllerIndex < 0
+							   ? OXYGENMAXCONTROLLERS - 1
+							   : binding.m_controllerIndex;
+				}
+				for (auto c = first; c <= last; ++c)
+				{
+					CompiledBinding compiled{};
+					compiled.m_slot =
+						GetSlot(binding.m_source, binding.m_index, c);
+					compiled.m_modifierCount = binding.m_modifierCount;
+					compiled.m_scale = binding.m_scale;
+					triggers.emplace_back(compiled.m_slot, a);
+					for (oxySize m = 0; m < binding.m_modifierCount; ++m)
+					{
+						compiled.m_modifiers[m] = binding.m_modifiers[m];
+						triggers.emplace_back(
+							GetSlot(InputBindingSource_Keyboard,
+									binding.m_modifiers[m], 0),
+							a);
+					}
+					m_compiledBindings.push_back(compiled);
+				}
+			}
+		}
+		m_actionBindingOffsets.push_back(
+			static_cast<oxyU32>(m_compiledBindings.size()));
+
+		std::ranges::sort(triggers);
+		const auto [first, last] = std::ranges::unique(triggers);
+		triggers.erase(first, last);
+		m_slotActionOffsets.assign(k_slotCount + 1, 0);
+		m_slotActions.clear();
+		for (const auto& [slot, action] : triggers)
+		{
+			m_slotActionOffsets[slot + 1]++;
+			m_slotActions.push_back(action);
+		}
+		for (oxySize i = 0; i < k_slotCount; ++i)
+			m_slotActionOffsets[i + 1] += m_slotActionOffsets[i];
+
+		m_isActionDirty.assign(m_actions.size(), 0);
+		m_dirtyActions.clear();
+		// Bindings changed, re-evaluate everything once.
+		for (oxyU32 a = 0; a < m_actions.size(); ++a)
+		{
+			m_isActionDirty[a] = 1;
+			m_dirtyActions.push_back(a);
+		}
+		m_isCompiled = true;
+	}
+
+	auto InputActionMap::IsActionActive(oxyU32 action) const -> oxyBool
+	{
+		return GetActionValue(action) != 0.0f;
+	}
+
+	auto InputActionMap::GetActionValue(oxyU32 action) const -> oxyF32
+	{
+		OXYCHECK(action < m_actions.size());
+		return m_actions[action].m_value;
+	}
+
+	auto InputActionMap::MarkSlotChanged(oxyU16 slot) -> void
+	{
+		if (!m_isCompiled)
+			return;
+		const auto begin = m_slotActionOffsets[slot];
+		const auto end = m_slotActionOffsets[slot + 1];
+		for (auto i = begin; i < end; ++i)
+		{
+			const auto action = m_slotActions[i];
+			if (!m_isActionDirty[action])
+			{
+				m_isActionDirty[action] = 1;
+				m_dirtyActions.push_back(action);
+			}
+		}
+	}
+
+	auto InputActionMap::MarkInputChanged(InputBindingSource source,
+										  oxyU8 index, oxyS32 controllerIndex,
+										  oxyU64 captureTime) -> void
+	{
+		if (captureTime && (!m_dirtyCaptureTime ||
+							captureTime < m_dirtyCaptureTime))
+			m_dirtyCaptureTime = captureTime;
+		MarkSlotChanged(GetSlot(source, index, controllerIndex));
+	}
+
+	auto InputActionMap::ReadSlot(const InputManager& input, oxyU16 slot) const
+		-> oxyF32
+	{
+		if (slot < k_mouseSlotBase)
+			return input.IsKeyDown(
+				static_cast<KeyboardButton>(slot - k_keyboardSlotBase));
+		if (slot < k_controllerButtonSlotBase)
+			return input.IsMouseButtonDown(
+				static_cast<MouseButton>(slot - k_mouseSlotBase));
+		if (slot < k_controllerAxisSlotBase)
+		{
+			const auto i = slot - k_controllerButtonSlotBase;
+			return input.IsControllerButtonDown(
+				i / ControllerButton_Count,
+				static_cast<ControllerButton>(i % ControllerButton_Count));
+		}
+		const auto i = slot - k_controllerAxisSlotBase;
+		return input.GetControllerAxisValue(
+			i / ControllerAxis_Count,
+			static_cast<ControllerAxis>(i % ControllerAxis_Count));
+	}
+
+	auto InputActionMap::Evaluate(const InputManager& input) -> void
+	{
+		if (!m_isCompiled)
+			Compile();
+		if (m_dirtyActions.empty())
+		{
+			m_dirtyCaptureTime = 0;
+			return;
+		}
+		auto& em = EventManager::GetInstance();
+		for (const auto a : m_dirtyActions)
+		{
+			m_isActionDirty[a] = 0;
+			// The binding with the largest magnitude wins
+			oxyF32 value{};
+			const auto begin = m_actionBindingOffsets[a];
+			const auto end = m_actionBindingOffsets[a + 1];
+			for (auto b = begin; b < end; ++b)
+			{
+				const auto& binding = m_compiledBindings[b];
+				oxyBool modifiersHeld{true};
+				for (oxySize m = 0; m < binding.m_modifierCount; ++m)
+					modifiersHeld &= input.IsKeyDown(binding.m_modifiers[m]);
+				if (!modifiersHeld)
+					continue;
+				const auto bindingValue =
+					ReadSlot(input, binding.m_slot) * binding.m_scale;
+				if (std::abs(bindingValue) > std::abs(value))
+					value = bindingValue;
+			}
+			auto& action = m_actions[a];
+			if (value == action.m_value)
+				continue;
+			InputActionStateChangedEvent event{};
+			event.m_captureTime = m_dirtyCaptureTime;
+			event.m_action = a;
+			event.m_isActive = value != 0.0f;
+			event.m_value = value;
+			event.m_prevValue = action.m_value;
+			action.m_value = value;
+			em.QueueEvent<InputActionStateChangedEvent>(event);
+		}
+		m_dirtyActions.clear();
+		m_dirtyCaptureTime = 0;
+	}
+}; // namespace oxygen
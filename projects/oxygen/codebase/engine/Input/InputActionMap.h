@@ -0,0 +1,106 @@
+#pragma once
+
+namespace oxygen
+{
+	struct InputManager;
+
+	enum InputBindingSource : oxyU8
+	{
+		InputBindingSource_Keyboard,
+		InputBindingSource_Mouse,
+		InputBindingSource_ControllerButton,
+		InputBindingSource_ControllerAxis,
+		InputBindingSource_Count
+	};
+
+	/**
+	 * @brief Binds one input to an action. Digital inputs contribute m_scale
+	 * while held, axes contribute their value times m_scale. The binding only
+	 * applies while all modifier keys are held.
+	 */
+	struct InputBinding
+	{
+		static inline constexpr oxySize k_maxModifiers{2};
+
+		InputBindingSource m_source{};
+		// KeyboardButton, MouseButton, ControllerButton or ControllerAxis
+		oxyU8 m_index{};
+		// Controller to read from, -1 for any controller
+		oxyS8 m_controllerIndex{-1};
+		oxyU8 m_modifierCount{};
+		KeyboardButton m_modifiers[k_maxModifiers]{};
+		oxyF32 m_scale{1.0f};
+	};
+
+	/**
+	 * @brief Maps named actions to inputs. Bindings are compiled into flat
+	 * tables from input to action, so each frame only the actions bound to an
+	 * input that changed are re-evaluated. Changes are queued as
+	 * InputActionStateChangedEvent, keyed by action index.
+	 */
+	struct InputActionMap : NonCopyable
+	{
+		static inline constexpr oxyU32 k_invalidAction{~0U};
+
+		/**
+		 * @brief Adds an action, or returns the existing one with that name.
+		 * @return Dense action index, used as event key.
+		 */
+		auto AddAction(std::string_view name) -> oxyU32;
+		auto FindAction(std::string_view name) const -> oxyU32;
+		auto GetActionName(oxyU32 action) const -> std::string_view;
+		auto AddBinding(oxyU32 action, const InputBinding& binding) -> void;
+		auto ClearBindings(oxyU32 action) -> void;
+
+		/**
+		 * @brief Rebuilds the lookup tables. Called automatically by the next
+		 * evaluation after the bindings changed.
+		 */
+		auto Compile() -> void;
+
+		auto IsActionActive(oxyU32 action) const -> oxyBool;
+		auto GetActionValue(oxyU32 action) const -> oxyF32;
+
+	  private:
+		struct Action
+		{
+			std::string m_name{};
+			oxyU64 m_id{};
+			std::vector<InputBinding> m_bindings{};
+			oxyF32 m_value{};
+		};
+		std::vector<Action> m_actions{};
+		oxyBool m_isCompiled{};
+
+		// Bindings with m_controllerIndex == -1 are expanded per controller,
+		// so every compiled binding reads exactly one input slot.
+		struct CompiledBinding
+		{
+			oxyU16 m_slot{};
+			oxyU8 m_modifierCount{};
+			KeyboardButton m_modifiers[InputBinding::k_maxModifiers]{};
+			oxyF32 m_scale{};
+		};
+		// Per action ranges into m_compiledBindings
+		std::vector<oxyU32> m_actionBindingOffsets{};
+		std::vector<CompiledBinding> m_compiledBindings{};
+		// Per input slot ranges into m_slotActions, the actions to re-evaluate
+		// when the slot changes. Modifier keys are listed as well.
+		std::vector<oxyU32> m_slotActionOffsets{};
+		std::vector<oxyU32> m_slotActions{};
+
+		std::vector<oxyU8> m_isActionDirty{};
+		std::vector<oxyU32> m_dirtyActions{};
+		// Earliest capture time of the inputs that dirtied the actions
+		oxyU64 m_dirtyCaptureTime{};
+
+		auto MarkSlotChanged(oxyU16 slot) -> void;
+		auto MarkInputChanged(InputBindingSource source, oxyU8 index,
+							  oxyS32 controllerIndex, oxyU64 captureTime)
+			-> void;
+		auto Evaluate(const InputManager& input) -> void;
+		auto ReadSlot(const InputManager& input, oxyU16 slot) const -> oxyF32;
+
+		friend struct InputManager;
+	};
+}; // namespace oxygen
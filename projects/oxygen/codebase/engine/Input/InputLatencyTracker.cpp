@@ -0,0 +1,198 @@
+#include "OxygenPCH.h"
+#include "InputLatencyTracker.h"
+
+#include "Events/EventManager.h"
+#include "Platform/Platform.h"
+
+namespace oxygen
+{
+	namespace
+	{
+		// Every event type deriving from InputEvent
+		constexpr EventType k_inputEventTypes[]{
+			EventType_KeyboardButtonStateChangedEvent,
+			EventType_MouseButtonStateChangedEvent,
+			EventType_MouseMovedEvent,
+			EventType_ControllerConnectionStateChangedEvent,
+			EventType_ControllerAxisValueChangedEvent,
+			EventType_ControllerButtonStateChangedEvent,
+			EventType_InputActionStateChangedEvent,
+		};
+
+		/**
+		 * @brief Nearest rank percentile, reorders values in place.
+		 */
+		auto Percentile(std::vector<oxyU64>& values, oxyF32 percentile)
+			-> oxyU64
+		{
+			if (values.empty())
+				return 0;
+			const auto rank = static_cast<oxySize>(
+				std::ceil(percentile / 100.0f * values.size()));
+			const auto index = std::clamp<oxySize>(rank, 1, values.size()) - 1;
+			std::ranges::nth_element(values, values.begin() + index);
+			return values[index];
+		}
+	}; // namespace
+
+	InputLatencyTracker::~InputLatencyTracker()
+	{
+		SetEnabled(false);
+	}
+
+	auto InputLatencyTracker::SetEnabled(oxyBool enabled) -> void
+	{
+		if (enabled == m_enabled)
+			return;
+		m_enabled = enabled;
+		auto& em = EventManager::GetInstance();
+		if (!enabled)
+		{
+			for (const auto handle : m_listeners)
+				em.UnregisterListener(handle);
+			m_listeners.clear();
+			m_pendingCaptureTimes.clear();
+			m_pendingDispatchLatencies.clear();
+			return;
+		}
+		// Registered before gameplay listeners whenever tracking is enabled
+		// at startup, so the dispatch time is taken before any handler runs.
+		for (const auto type : k_inputEventTypes)
+			m_listeners.push_back(em.RegisterListener(
+				type, &InputLatencyTracker::OnInputEvent, this, Event::k_noKey,
+				"InputLatencyTracker::OnInputEvent"));
+	}
+
+	auto InputLatencyTracker::IsEnabled() const -> oxyBool
+	{
+		return m_enabled;
+	}
+
+	auto InputLatencyTracker::Reset() -> void
+	{
+		m_frame = 0;
+		m_pendingCaptureTimes.clear();
+		m_pendingDispatchLatencies.clear();
+		m_frames.clear();
+		m_frameStart = 0;
+		m_dispatchLatencies.clear();
+		m_presentLatencies.clear();
+		m_eventStart = 0;
+	}
+
+	auto InputLatencyTracker::EndFrame() -> void
+	{
+		const auto frame = m_frame++;
+		if (m_pendingCaptureTimes.empty())
+			return;
+		const auto now = GetHighPrecisionTime();
+
+		std::vector<oxyU64> presentLatencies{};
+		presentLatencies.reserve(m_pendingCaptureTimes.size());
+		for (oxySize i = 0; i < m_pendingCaptureTimes.size(); ++i)
+		{
+			const auto captureTime = m_pendingCaptureTimes[i];
+			const auto presentLatency =
+				now > captureTime ? now - captureTime : 0;
+			presentLatencies.push_back(presentLatency);
+			// Order is irrelevant for percentiles, overwrite the oldest.
+			if (m_dispatchLatencies.size() < k_maxEventHistory)
+			{
+				m_dispatchLatencies.push_back(m_pendingDispatchLatencies[i]);
+				m_presentLatencies.push_back(presentLatency);
+				continue;
+			}
+			m_dispatchLatencies[m_eventStart] = m_pendingDispatchLatencies[i];
+			m_presentLatencies[m_eventStart] = presentLatency;
+			m_eventStart = (m_eventStart + 1) % k_maxEventHistory;
+		}
+
+		InputLatencyFrame result{};
+		result.m_frame = frame;
+		result.m_eventCount = static_cast<oxyU32>(presentLatencies.size());
+		auto& dispatch = m_pendingDispatchLatencies;
+		result.m_dispatchP50 = Percentile(dispatch, 50.0f);
+		result.m_dispatchP95 = Percentile(dispatch, 95.0f);
+		result.m_dispatchP99 = Percentile(dispatch, 99.0f);
+		result.m_dispatchMax = Percentile(dispatch, 100.0f);
+		result.m_presentP50 = Percentile(presentLatencies, 50.0f);
+		result.m_presentP95 = Percentile(presentLatencies, 95.0f);
+		result.m_presentP99 = Percentile(presentLatencies, 99.0f);
+		result.m_presentMax = Percentile(presentLatencies, 100.0f);
+		if (m_frames.size() < k_maxFrameHistory)
+			m_frames.push_back(result);
+		else
+		{
+			m_frames[m_frameStart] = result;
+			m_frameStart = (m_frameStart + 1) % k_maxFrameHistory;
+		}
+
+		m_pendingCaptureTimes.clear();
+		m_pendingDispatchLatencies.clear();
+	}
+
+	auto InputLatencyTracker::GetFrameCount() const -> oxySize
+	{
+		return m_frames.size();
+	}
+
+	auto InputLatencyTracker::GetFrame(oxySize index) const
+		-> const InputLatencyFrame&
+	{
+		OXYCHECK(index < m_frames.size());
+		return m_frames[(m_frameStart + index) % m_frames.size()];
+	}
+
+	auto InputLatencyTracker::GetDispatchPercentile(oxyF32 percentile) const
+		-> oxyU64
+	{
+		auto values = m_dispatchLatencies;
+		return Percentile(values, percentile);
+	}
+
+	auto InputLatencyTracker::GetPresentPercentile(oxyF32 percentile) const
+		-> oxyU64
+	{
+		auto values = m_presentLatencies;
+		return Percentile(values, percentile);
+	}
+
+	auto InputLatencyTracker::DumpCSV() const -> std::string
+	{
+		const auto ms = [](oxyU64 time) {
+			return HighPrecisionTimeToSeconds(time) * 1e3;
+		};
+		std::string out{"frame,events,dispatch_p50_ms,dispatch_p95_ms,"
+						"dispatch_p99_ms,dispatch_max_ms,present_p50_ms,"
+						"present_p95_ms,present_p99_ms,present_max_ms\n"};
+		char line[512]{};
+		for (oxySize i = 0; i < GetFrameCount(); ++i)
+		{
+			const auto& frame = GetFrame(i);
+			std::snprintf(line, sizeof line,
+						  "%llu,%u,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+						  static_cast<unsigned long long>(frame.m_frame),
+						  frame.m_eventCount, ms(frame.m_dispatchP50),
+						  ms(frame.m_dispatchP95), ms(frame.m_dispatchP99),
+						  ms(frame.m_dispatchMax), ms(frame.m_presentP50),
+						  ms(frame.m_presentP95), ms(frame.m_presentP99),
+						  ms(frame.m_presentMax));
+			out += line;
+		}
+		return out;
+	}
+
+	auto InputLatencyTracker::OnInputEvent(void* tracker, const Event& event)
+		-> void
+	{
+		auto& self = *static_cast<InputLatencyTracker*>(tracker);
+		const auto captureTime =
+			static_cast<const InputEvent&>(event).m_captureTime;
+		if (!captureTime)
+			return;
+		const auto now = GetHighPrecisionTime();
+		self.m_pendingCaptureTimes.push_back(captureTime);
+		self.m_pendingDispatchLatencies.push_back(
+			now > captureTime ? now - captureTime : 0);
+	}
+}; // namespace oxygen
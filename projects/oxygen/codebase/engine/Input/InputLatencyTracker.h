@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Events/Event.h"
+
+namespace oxygen
+{
+	/**
+	 * @brief Latency distribution of the input events consumed by one frame,
+	 * in high precision time units.
+	 */
+	struct InputLatencyFrame
+	{
+		oxyU64 m_frame{};
+		oxyU32 m_eventCount{};
+		// Capture to the start of event dispatch
+		oxyU64 m_dispatchP50{};
+		oxyU64 m_dispatchP95{};
+		oxyU64 m_dispatchP99{};
+		oxyU64 m_dispatchMax{};
+		// Capture to the end of the frame that consumed the event
+		oxyU64 m_presentP50{};
+		oxyU64 m_presentP95{};
+		oxyU64 m_presentP99{};
+		oxyU64 m_presentMax{};
+	};
+
+	/**
+	 * @brief Measures how long input takes from capture in the platform layer
+	 * to dispatch and to the end of the consuming frame. While enabled, it
+	 * listens to every InputEvent type and reads InputEvent::m_captureTime.
+	 * EndFrame must be called once the frame has been presented.
+	 */
+	struct InputLatencyTracker : NonCopyable
+	{
+		static inline constexpr oxySize k_maxFrameHistory{4096};
+		static inline constexpr oxySize k_maxEventHistory{0x10000};
+
+		~InputLatencyTracker();
+
+		/**
+		 * @brief Off by default. Disabled tracking registers no listeners
+		 * and costs nothing.
+		 */
+		auto SetEnabled(oxyBool enabled) -> void;
+		auto IsEnabled() const -> oxyBool;
+		auto Reset() -> void;
+
+		/**
+		 * @brief Closes the current frame. Frames without input events are
+		 * not recorded.
+		 */
+		auto EndFrame() -> void;
+
+		/**
+		 * @brief Recorded frames, index 0 is the oldest. Only the last
+		 * k_maxFrameHistory frames are kept.
+		 */
+		auto GetFrameCount() const -> oxySize;
+		auto GetFrame(oxySize index) const -> const InputLatencyFrame&;
+
+		/**
+		 * @brief Percentile over the last k_maxEventHistory events.
+		 * @param percentile In the range [0, 100].
+		 */
+		auto GetDispatchPercentile(oxyF32 percentile) const -> oxyU64;
+		auto GetPresentPercentile(oxyF32 percentile) const -> oxyU64;
+
+		/**
+		 * @brief One CSV row per recorded frame, latencies in milliseconds.
+		 */
+		auto DumpCSV() const -> std::string;
+
+	  private:
+		oxyBool m_enabled{};
+		std::vector<EventListenerHandle> m_listeners{};
+
+		oxyU64 m_frame{};
+		// Capture times of the events dispatched during the current frame
+		std::vector<oxyU64> m_pendingCaptureTimes{};
+		std::vector<oxyU64> m_pendingDispatchLatencies{};
+
+		std::vector<InputLatencyFrame> m_frames{};
+		oxySize m_frameStart{};
+		// Per event history for the aggregate percentiles
+		std::vector<oxyU64> m_dispatchLatencies{};
+		std::vector<oxyU64> m_presentLatencies{};
+		oxySize m_eventStart{};
+
+		static auto OnInputEvent(void* tracker, const Event& event) -> void;
+	};
+}; // namespace oxygen
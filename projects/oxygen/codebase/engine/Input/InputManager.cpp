@@ -2,63 +2,255 @@
 #include "InputManager.h"
 
 #include "Events/EventManager.h"
+#include "Platform/Platform.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define OXYINPUTSSE2
+#endif
 
 namespace oxygen
 {
+	namespace
+	{
+		/**
+		 * @brief Calls fun(index, isDown) for every bit that differs between
+		 * current and previous. The XOR runs 128 bits at a time, so a frame
+		 * without button changes only costs a few instructions.
+		 */
+		template <oxySize BitCount, typename Fun>
+		auto ForEachChangedBit(const InputBitset<BitCount>& current,
+							   const InputBitset<BitCount>& previous,
+							   Fun&& fun) -> void
+		{
+			constexpr auto wordCount = InputBitset<BitCount>::k_wordCount;
+			alignas(16) oxyU64 changed[wordCount];
+			oxySize i{};
+#ifdef OXYINPUTSSE2
+			for (; i + 2 <= wordCount; i += 2)
+			{
+				const auto cur = _mm_load_si128(
+					reinterpret_cast<const __m128i*>(&current.m_words[i]));
+				const auto prev = _mm_load_si128(
+					reinterpret_cast<const __m128i*>(&previous.m_words[i]));
+				_mm_store_si128(reinterpret_cast<__m128i*>(&changed[i]),
+								_mm_xor_si128(cur, prev));
+			}
+#endif
+			for (; i < wordCount; ++i)
+				changed[i] = current.m_words[i] ^ previous.m_words[i];
+
+			oxyU64 any{};
+			for (i = 0; i < wordCount; ++i)
+				any |= changed[i];
+			if (!any)
+				return;
+
+			for (i = 0; i < wordCount; ++i)
+			{
+				auto word = changed[i];
+				while (word)
+				{
+					const auto bit = i * 64 + std::countr_zero(word);
+					fun(bit, current.Test(bit));
+					word &= word - 1;
+				}
+			}
+		}
+
+		/**
+		 * @brief Samples can be pushed from any thread, one whose index is
+		 * out of range is dropped instead of written past the state arrays.
+		 */
+		auto IsInRange(oxyU8 index, oxyU32 count) -> oxyBool
+		{
+			OXYCHECK(index < count);
+			return index < count;
+		}
+
+		/**
+		 * @brief The other axis of the same thumbstick, or ControllerAxis_Count
+		 * for triggers.
+		 */
+		auto GetThumbstickPartner(oxyU8 axis) -> oxyU8
+		{
+			if (axis > ControllerAxis_RightThumbY)
+				return ControllerAxis_Count;
+			return axis ^ 1;
+		}
+	}; // namespace
+
 	auto InputManager::BeginUpdate(oxyF32 deltaTimeSeconds) -> void
 	{
 		m_lastUpdateState = m_state;
+		m_frameSamples.clear();
+		m_frameMousePath.clear();
+		m_sampleBuffer.Drain([&](const InputSample& sample) {
+			m_frameSamples.push_back(sample);
+			if (sample.m_type == InputSampleType_MouseMoved)
+				m_frameMousePath.push_back(sample);
+			ApplySample(sample);
+		});
+	}
+	auto InputManager::PushSample(InputSample sample) -> oxyBool
+	{
+		if (!sample.m_time)
+			sample.m_time = GetHighPrecisionTime();
+		return m_sampleBuffer.Push(sample);
+	}
+	auto InputManager::GetFrameSamples() const -> std::span<const InputSample>
+	{
+		return m_frameSamples;
+	}
+	auto InputManager::GetMousePath() const -> std::span<const InputSample>
+	{
+		return m_frameMousePath;
+	}
+	auto InputManager::ApplySample(const InputSample& sample) -> void
+	{
+		auto& controllers = m_state.m_controllers;
+		const auto c = sample.m_controllerIndex;
+		switch (sample.m_type)
+		{
+		case InputSampleType_KeyboardButton:
+			if (!IsInRange(sample.m_index, KeyboardButton_Count))
+				return;
+			m_state.m_keyboard.m_keys.Set(sample.m_index, sample.m_isDown);
+			m_state.m_keyboard.m_captureTime = sample.m_time;
+			break;
+		case InputSampleType_MouseButton:
+			if (!IsInRange(sample.m_index, MouseButton_Count))
+				return;
+			m_state.m_mouse.m_buttons.Set(sample.m_index, sample.m_isDown);
+			m_state.m_mouse.m_captureTime = sample.m_time;
+			break;
+		case InputSampleType_MouseMoved:
+			m_state.m_mouse.m_x = sample.m_x;
+			m_state.m_mouse.m_y = sample.m_y;
+			m_state.m_mouse.m_captureTime = sample.m_time;
+			break;
+		case InputSampleType_ControllerConnection:
+			if (!IsInRange(c, OXYGENMAXCONTROLLERS))
+				return;
+			controllers[c].m_connected = sample.m_isDown;
+			controllers[c].m_captureTime = sample.m_time;
+			break;
+		case InputSampleType_ControllerButton:
+			if (!IsInRange(c, OXYGENMAXCONTROLLERS) ||
+				!IsInRange(sample.m_index, ControllerButton_Count))
+				return;
+			controllers[c].m_buttonValues.Set(sample.m_index,
+											  sample.m_isDown);
+			controllers[c].m_captureTime = sample.m_time;
+			break;
+		case InputSampleType_ControllerAxis:
+			if (!IsInRange(c, OXYGENMAXCONTROLLERS) ||
+				!IsInRange(sample.m_index, ControllerAxis_Count))
+				return;
+			m_rawAxisValues[c][sample.m_index] = sample.m_x;
+			controllers[c].m_captureTime = sample.m_time;
+			break;
+		default:
+			OXYCHECK(false);
+			break;
+		}
 	}
 	auto InputManager::UpdateController(oxyS32 index,
 										const ControllerInputState& input)
 		-> void
 	{
 		m_state.m_controllers[index] = input;
+		std::ranges::copy(input.m_axisValues, m_rawAxisValues[index]);
+		if (!input.m_captureTime)
+			m_state.m_controllers[index].m_captureTime = GetHighPrecisionTime();
 	}
 	auto InputManager::UpdateMouse(const MouseInputState& input) -> void
 	{
 		m_state.m_mouse = input;
+		if (!input.m_captureTime)
+			m_state.m_mouse.m_captureTime = GetHighPrecisionTime();
 	}
 	auto InputManager::UpdateKeyboard(const KeyboardInputState& input) -> void
 	{
 		m_state.m_keyboard = input;
+		if (!input.m_captureTime)
+			m_state.m_keyboard.m_captureTime = GetHighPrecisionTime();
 	}
-	auto InputManager::EndUpdate() -> void
+	auto InputManager::SetControllerAxisFilter(
+		ControllerAxis axis, const ControllerAxisFilter& filter) -> void
 	{
-		auto& em = EventManager::GetInstance();
-
-		for (oxyU8 i = KeyboardButton{}; i < KeyboardButton_Count; ++i)
+		OXYCHECK(filter.m_deadzone >= 0.0f && filter.m_deadzone < 1.0f);
+		m_axisFilters[axis] = filter;
+	}
+	auto InputManager::GetControllerAxisFilter(ControllerAxis axis) const
+		-> const ControllerAxisFilter&
+	{
+		return m_axisFilters[axis];
+	}
+	auto InputManager::FilterAxisValues(oxyS32 index) -> void
+	{
+		const auto& raw = m_rawAxisValues[index];
+		auto& filtered = m_state.m_controllers[index].m_axisValues;
+		for (oxyU8 j = ControllerAxis{}; j < ControllerAxis_Count; ++j)
 		{
-			const auto isDown = IsKeyDown(static_cast<KeyboardButton>(i));
-			const auto wasDown = WasKeyDown(static_cast<KeyboardButton>(i));
-			if (isDown != wasDown)
+			const auto& filter = m_axisFilters[j];
+			auto magnitude = std::abs(raw[j]);
+			const auto partner = GetThumbstickPartner(j);
+			if (filter.m_isRadial && partner != ControllerAxis_Count)
+				magnitude = std::sqrt(raw[j] * raw[j] +
+									  raw[partner] * raw[partner]);
+			if (magnitude <= filter.m_deadzone)
 			{
-				KeyboardButtonStateChangedEvent event{};
-				event.m_button = static_cast<KeyboardButton>(i);
-				event.m_isDown = isDown;
-				em.QueueEvent<KeyboardButtonStateChangedEvent>(event);
+				filtered[j] = 0.0f;
+				continue;
 			}
+			// Rescale so the output starts at zero on the deadzone edge.
+			const auto scaled =
+				(std::min(magnitude, 1.0f) - filter.m_deadzone) /
+				(1.0f - filter.m_deadzone);
+			filtered[j] = std::clamp(raw[j] * scaled / magnitude, -1.0f, 1.0f);
 		}
+	}
+	auto InputManager::EndUpdate() -> void
+	{
+		auto& em = EventManager::GetInstance();
+		const auto keyboardTime = m_state.m_keyboard.m_captureTime;
+		const auto mouseTime = m_state.m_mouse.m_captureTime;
 
-		for (oxyU8 i = MouseButton{}; i < MouseButton_Count; ++i)
-		{
-			const auto isDown = IsMouseButtonDown(static_cast<MouseButton>(i));
-			const auto wasDown =
-				WasMouseButtonDown(static_cast<MouseButton>(i));
-			if (isDown != wasDown)
-			{
-				MouseButtonStateChangedEvent event{};
-				event.m_button = static_cast<MouseButton>(i);
-				event.m_isDown = isDown;
-				em.QueueEvent<MouseButtonStateChangedEvent>(event);
-			}
-		}
+		ForEachChangedBit(m_state.m_keyboard.m_keys,
+						  m_lastUpdateState.m_keyboard.m_keys,
+						  [&](oxySize i, oxyBool isDown) {
+							  KeyboardButtonStateChangedEvent event{};
+							  event.m_captureTime = keyboardTime;
+							  event.m_button = static_cast<KeyboardButton>(i);
+							  event.m_isDown = isDown;
+							  em.QueueEvent<KeyboardButtonStateChangedEvent>(
+								  event);
+							  m_actionMap.MarkInputChanged(
+								  InputBindingSource_Keyboard,
+								  static_cast<oxyU8>(i), 0, keyboardTime);
+						  });
+
+		ForEachChangedBit(m_state.m_mouse.m_buttons,
+						  m_lastUpdateState.m_mouse.m_buttons,
+						  [&](oxySize i, oxyBool isDown) {
+							  MouseButtonStateChangedEvent event{};
+							  event.m_captureTime = mouseTime;
+							  event.m_button = static_cast<MouseButton>(i);
+							  event.m_isDown = isDown;
+							  em.QueueEvent<MouseButtonStateChangedEvent>(
+								  event);
+							  m_actionMap.MarkInputChanged(
+								  InputBindingSource_Mouse,
+								  static_cast<oxyU8>(i), 0, mouseTime);
+						  });
 
 		{
 			if (m_state.m_mouse.m_x != m_lastUpdateState.m_mouse.m_x ||
 				m_state.m_mouse.m_y != m_lastUpdateState.m_mouse.m_y)
 			{
 				MouseMovedEvent event{};
+				event.m_captureTime = mouseTime;
 				event.m_x = static_cast<oxyS32>(m_state.m_mouse.m_x);
 				event.m_y = static_cast<oxyS32>(m_state.m_mouse.m_y);
 				event.m_prevX =
@@ -76,66 +268,83 @@ namespace oxygen
 		{
 			for (auto i = 0; i < OXYGENMAXCONTROLLERS; ++i)
 			{
-				const auto isConnected = IsControllerConnected(i);
-				const auto wasConnected =
-					m_lastUpdateState.m_controllers[i].m_connected;
-				if (isConnected != wasConnected)
+				const auto& controller = m_state.m_controllers[i];
+				const auto& lastController = m_lastUpdateState.m_controllers[i];
+				if (controller.m_connected != lastController.m_connected)
 				{
 					ControllerConnectionStateChangedEvent event{};
+					event.m_captureTime = controller.m_captureTime;
 					event.m_controllerIndex = i;
-					event.m_isConnected = isConnected;
+					event.m_isConnected = controller.m_connected;
 					em.QueueEvent<ControllerConnectionStateChangedEvent>(event);
 				}
 
+				FilterAxisValues(i);
 				for (oxyU8 j = ControllerAxis{}; j < ControllerAxis_Count; ++j)
 				{
-					const auto value = GetControllerAxisValue(i, static_cast<ControllerAxis>(j));
-					const auto prevValue =
-						m_lastUpdateState.m_controllers[i].m_axisValues[j];
-					if (value != prevValue)
+					const auto value = controller.m_axisValues[j];
+					auto& reported = m_reportedAxisValues[i][j];
+					const auto isEndpoint =
+						value == 0.0f || std::abs(value) == 1.0f;
+					if (value != reported &&
+						(isEndpoint || std::abs(value - reported) >=
+										   m_axisFilters[j].m_changeThreshold))
 					{
 						ControllerAxisValueChangedEvent event{};
+						event.m_captureTime = controller.m_captureTime;
 						event.m_controllerIndex = i;
 						event.m_axis = static_cast<ControllerAxis>(j);
 						event.m_value = value;
+						event.m_prevValue = reported;
+						reported = value;
 						em.QueueEvent<ControllerAxisValueChangedEvent>(event);
+						m_actionMap.MarkInputChanged(
+							InputBindingSource_ControllerAxis, j, i,
+							controller.m_captureTime);
 					}
 				}
 
-				for (oxyU8 j = ControllerButton{}; j < ControllerButton_Count;
-					++j)
-				{
-					const auto isDown =
-						IsControllerButtonDown(i, static_cast<ControllerButton>(j));
-					const auto wasDown = WasControllerButtonDown(
-						i, static_cast<ControllerButton>(j));
-					if (isDown != wasDown)
-					{
+				ForEachChangedBit(
+					controller.m_buttonValues, lastController.m_buttonValues,
+					[&](oxySize j, oxyBool isDown) {
 						ControllerButtonStateChangedEvent event{};
+						event.m_captureTime = controller.m_captureTime;
 						event.m_controllerIndex = i;
 						event.m_button = static_cast<ControllerButton>(j);
 						event.m_isDown = isDown;
 						em.QueueEvent<ControllerButtonStateChangedEvent>(event);
-					}
-				}
+						m_actionMap.MarkInputChanged(
+							InputBindingSource_ControllerButton,
+							static_cast<oxyU8>(j), i, controller.m_captureTime);
+					});
 			}
 		}
+
+		m_actionMap.Evaluate(*this);
+	}
+	auto InputManager::GetActionMap() -> InputActionMap&
+	{
+		return m_actionMap;
+	}
+	auto InputManager::GetLatencyTracker() -> InputLatencyTracker&
+	{
+		return m_latencyTracker;
 	}
 	auto InputManager::IsKeyDown(KeyboardButton button) const -> oxyBool
 	{
-		return m_state.m_keyboard.m_keys[button];
+		return m_state.m_keyboard.m_keys.Test(button);
 	}
 	auto InputManager::WasKeyDown(KeyboardButton button) const -> oxyBool
 	{
-		return m_lastUpdateState.m_keyboard.m_keys[button];
+		return m_lastUpdateState.m_keyboard.m_keys.Test(button);
 	}
 	auto InputManager::IsMouseButtonDown(MouseButton button) const -> oxyBool
 	{
-		return m_state.m_mouse.m_buttons[button];
+		return m_state.m_mouse.m_buttons.Test(button);
 	}
 	auto InputManager::WasMouseButtonDown(MouseButton button) const -> oxyBool
 	{
-		return m_lastUpdateState.m_mouse.m_buttons[button];
+		return m_lastUpdateState.m_mouse.m_buttons.Test(button);
 	}
 	auto InputManager::GetMousePosition(oxyS32& x, oxyS32& y) const -> void
 	{
@@ -157,16 +366,23 @@ namespace oxygen
 	{
 		return m_state.m_controllers[index].m_axisValues[axis];
 	}
+	auto InputManager::GetRawControllerAxisValue(oxyS32 index,
+												 ControllerAxis axis) const
+		-> oxyF32
+	{
+		return m_rawAxisValues[index][axis];
+	}
 	auto InputManager::IsControllerButtonDown(oxyS32 index,
 											  ControllerButton button) const
 		-> oxyBool
 	{
-		return m_state.m_controllers[index].m_buttonValues[button];
+		return m_state.m_controllers[index].m_buttonValues.Test(button);
 	}
 	auto InputManager::WasControllerButtonDown(oxyS32 index,
 											   ControllerButton button) const
 		-> oxyBool
 	{
-		return m_lastUpdateState.m_controllers[index].m_buttonValues[button];
+		return m_lastUpdateState.m_controllers[index].m_buttonValues.Test(
+			button);
 	}
 }; // namespace oxygen
\ No newline at end of file
@@ -2,8 +2,30 @@
 
 #include "Singleton/Singleton.h"
 
+#include "InputActionMap.h"
+#include "InputLatencyTracker.h"
+#include "InputSampleBuffer.h"
+
 namespace oxygen
 {
+	/**
+	 * @brief Noise filtering applied to a controller axis before its value is
+	 * stored and reported.
+	 */
+	struct ControllerAxisFilter
+	{
+		// Magnitudes below this read as zero, the remaining range is rescaled
+		// to [0, 1].
+		oxyF32 m_deadzone{};
+		// Apply the deadzone to the combined magnitude of both thumbstick
+		// axes instead of each axis separately. Ignored for triggers.
+		oxyBool m_isRadial{};
+		// Minimum difference to the last reported value before a
+		// ControllerAxisValueChangedEvent is queued. Returning to zero or full
+		// deflection is always reported.
+		oxyF32 m_changeThreshold{};
+	};
+
 	/**
 	 * @brief Singleton class that operates the input interface. Input state
 	 * should be accessed during update calls and event callbacks.
@@ -11,12 +33,35 @@ namespace oxygen
 	struct InputManager : SingletonBase<InputManager>
 	{
 		auto BeginUpdate(oxyF32 deltaTimeSeconds) -> void;
+		/**
+		 * @brief Replace a device state. A zero m_captureTime is replaced with
+		 * the current time.
+		 */
 		auto UpdateController(oxyS32 index, const ControllerInputState& input)
 			-> void;
 		auto UpdateMouse(const MouseInputState& input) -> void;
 		auto UpdateKeyboard(const KeyboardInputState& input) -> void;
 		auto EndUpdate() -> void;
 
+		/**
+		 * @brief Queue a raw input change from a platform or input thread, may
+		 * be called at any rate from a single producer thread. Samples are
+		 * applied to the input state in order at the next BeginUpdate. A zero
+		 * m_time is replaced with the current time, and becomes the capture
+		 * time of the resulting events.
+		 * @return False if the buffer is full and the sample was dropped.
+		 */
+		auto PushSample(InputSample sample) -> oxyBool;
+		/**
+		 * @brief All samples applied at the last BeginUpdate, in capture order.
+		 */
+		auto GetFrameSamples() const -> std::span<const InputSample>;
+		/**
+		 * @brief Mouse positions captured since the previous frame, in capture
+		 * order. Empty if the mouse is fed through UpdateMouse only.
+		 */
+		auto GetMousePath() const -> std::span<const InputSample>;
+
 		auto IsKeyDown(KeyboardButton button) const -> oxyBool;
 		auto WasKeyDown(KeyboardButton button) const -> oxyBool;
 		auto IsMouseButtonDown(MouseButton button) const -> oxyBool;
@@ -26,11 +71,32 @@ namespace oxygen
 		auto IsControllerConnected(oxyS32 index) const -> oxyBool;
 		auto GetControllerAxisValue(oxyS32 index, ControllerAxis axis) const
 			-> oxyF32;
+		/**
+		 * @brief Axis value as passed in, before ControllerAxisFilter.
+		 */
+		auto GetRawControllerAxisValue(oxyS32 index, ControllerAxis axis) const
+			-> oxyF32;
 		auto IsControllerButtonDown(oxyS32 index, ControllerButton button) const
 			-> oxyBool;
 		auto WasControllerButtonDown(oxyS32 index,
 									 ControllerButton button) const -> oxyBool;
 
+		/**
+		 * @brief Sets the filter used for the axis on every controller.
+		 * Defaults match the XInput recommended deadzones.
+		 */
+		auto SetControllerAxisFilter(ControllerAxis axis,
+									 const ControllerAxisFilter& filter)
+			-> void;
+		auto GetControllerAxisFilter(ControllerAxis axis) const
+			-> const ControllerAxisFilter&;
+
+		/**
+		 * @brief Named actions evaluated at the end of every EndUpdate.
+		 */
+		auto GetActionMap() -> InputActionMap&;
+		auto GetLatencyTracker() -> InputLatencyTracker&;
+
 	  private:
 		struct InputState
 		{
@@ -41,5 +107,26 @@ namespace oxygen
 
 		InputState m_state{};
 		InputState m_lastUpdateState{};
+
+		// m_state holds filtered axis values, the unfiltered input is kept
+		// here so filtering is never applied twice.
+		oxyF32 m_rawAxisValues[OXYGENMAXCONTROLLERS][ControllerAxis_Count]{};
+		// Values last sent in a ControllerAxisValueChangedEvent
+		oxyF32 m_reportedAxisValues[OXYGENMAXCONTROLLERS]
+								   [ControllerAxis_Count]{};
+		ControllerAxisFilter m_axisFilters[ControllerAxis_Count]{
+			{0.24f, true, 0.01f}, {0.24f, true, 0.01f}, {0.27f, true, 0.01f},
+			{0.27f, true, 0.01f}, {0.12f, false, 0.01f}, {0.12f, false, 0.01f},
+		};
+		auto FilterAxisValues(oxyS32 index) -> void;
+
+		static inline constexpr oxySize k_sampleBufferCapacity{4096};
+		SPSCRingBuffer<InputSample, k_sampleBufferCapacity> m_sampleBuffer{};
+		std::vector<InputSample> m_frameSamples{};
+		std::vector<InputSample> m_frameMousePath{};
+		auto ApplySample(const InputSample& sample) -> void;
+
+		InputActionMap m_actionMap{};
+		InputLatencyTracker m_latencyTracker{};
 	};
 }; // namespace oxygen
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+
+namespace oxygen
+{
+	enum InputSampleType : oxyU8
+	{
+		InputSampleType_KeyboardButton,
+		InputSampleType_MouseButton,
+		InputSampleType_MouseMoved,
+		InputSampleType_ControllerConnection,
+		InputSampleType_ControllerButton,
+		InputSampleType_ControllerAxis,
+		InputSampleType_Count
+	};
+
+	/**
+	 * @brief A single raw input change, timestamped with
+	 * GetHighPrecisionTime() when it was captured.
+	 */
+	struct InputSample
+	{
+		oxyU64 m_time{};
+		InputSampleType m_type{};
+		// Button or axis enum value, unused for MouseMoved
+		oxyU8 m_index{};
+		oxyU8 m_controllerIndex{};
+		// Button pressed or controller connected
+		oxyBool m_isDown{};
+		// Mouse position for MouseMoved, axis value in m_x for ControllerAxis
+		oxyF32 m_x{};
+		oxyF32 m_y{};
+	};
+
+	/**
+	 * @brief Fixed size lock-free ring buffer for one producer thread and one
+	 * consumer thread.
+	 * @tparam T Element type, must be trivially copyable.
+	 * @tparam Capacity Number of slots, must be a power of two.
+	 */
+	template <typename T, oxySize Capacity> struct SPSCRingBuffer : NonCopyable
+	{
+		static_assert(std::is_trivially_copyable_v<T>,
+					  "T must be trivially copyable");
+		static_assert(std::has_single_bit(Capacity),
+					  "Capacity must be a power of two");
+
+		/**
+		 * @brief Producer side. Returns false and drops the element if the
+		 * buffer is full.
+		 */
+		auto Push(const T& value) -> oxyBool
+		{
+			const auto head = m_head.load(std::memory_order_relaxed);
+			if (head - m_tail.load(std::memory_order_acquire) == Capacity)
+				return false;
+			m_slots[head & (Capacity - 1)] = value;
+			m_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * @brief Consumer side. Calls fun for every element pushed so far, in
+		 * push order, and removes them.
+		 */
+		template <typename Fun> auto Drain(Fun&& fun) -> oxySize
+		{
+			const auto tail = m_tail.load(std::memory_order_relaxed);
+			const auto head = m_head.load(std::memory_order_acquire);
+			for (auto i = tail; i != head; ++i)
+				fun(m_slots[i & (Capacity - 1)]);
+			m_tail.store(head, std::memory_order_release);
+			return head - tail;
+		}
+
+	  private:
+		// Separate cache lines so producer and consumer don't false share.
+		alignas(64) std::atomic<oxySize> m_head{};
+		alignas(64) std::atomic<oxySize> m_tail{};
+		alignas(64) T m_slots[Capacity]{};
+	};
+}; // namespace oxygen
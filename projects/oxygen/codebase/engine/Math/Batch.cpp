@@ -0,0 +1,830 @@
+#include "OxygenPCH.h"
+#include "Math/Batch.h"
+
+#include "Platform/CpuFeatures.h"
+
+// AVX2 kernels are compiled for every x86 build and only selected at run time
+// when the CPU supports them. They clear the upper register halves before
+// returning to SSE code, as compilers do not always do it for target
+// attributes. Deterministic builds leave them out, their FMA rounding would
+// depend on the machine.
+#if defined(OXYMATHSSE) && !defined(OXYMATHDETERMINISTIC)
+#define OXYMATHBATCHAVX2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define OXYTARGETAVX2
+#else
+#define OXYTARGETAVX2 __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+namespace oxygen
+{
+	namespace Math
+	{
+		namespace
+		{
+			using ComposeTRSKernel = auto (*)(const TRSStreams&, oxyMat4x4*,
+											  oxySize, oxySize) -> void;
+			using TransformKernel = auto (*)(const oxyMat4x4&,
+											 Vec3Streams<const oxyF32>,
+											 Vec3Streams<oxyF32>, oxyF32,
+											 oxySize) -> void;
+			using NormalizeKernel = auto (*)(Vec3Streams<const oxyF32>,
+											 Vec3Streams<oxyF32>, oxySize,
+											 oxySize) -> void;
+			using MultiplyKernel = auto (*)(const oxyMat4x4*, const oxyMat4x4*,
+											oxyMat4x4*, oxySize) -> void;
+			using QuatBlendKernel = auto (*)(const QuatBlendStreams&,
+											 oxySize, oxySize) -> void;
+			using CullSpheresKernel = auto (*)(const oxyFrustum&,
+											   const SphereStreams&, oxyU32*,
+											   oxySize, oxySize, oxySize)
+				-> oxySize;
+			using CullAABBsKernel = auto (*)(const oxyFrustum&,
+											 const AABBStreams&, oxyU32*,
+											 oxySize, oxySize, oxySize)
+				-> oxySize;
+
+			struct BatchKernels
+			{
+				ComposeTRSKernel m_composeTRS{};
+				TransformKernel m_transform{};
+				NormalizeKernel m_normalize{};
+				NormalizeKernel m_normalizeFast{};
+				MultiplyKernel m_multiply{};
+				QuatBlendKernel m_nlerp{};
+				QuatBlendKernel m_slerpFast{};
+				CullSpheresKernel m_cullSpheres{};
+				CullAABBsKernel m_cullAABBs{};
+				std::string_view m_backend{};
+			};
+
+			/**
+			 * @brief Composes transforms [begin, end). Also finishes the
+			 * remainder of the wide kernels.
+			 */
+			auto ComposeTRSScalar(const TRSStreams& trs, oxyMat4x4* out,
+								  oxySize begin, oxySize end) -> void
+			{
+				const auto& p = trs.m_position;
+				const auto& q = trs.m_rotation;
+				const auto& s = trs.m_scale;
+				for (oxySize i = begin; i < end; i++)
+				{
+					const auto x2 = q.m_x[i] + q.m_x[i];
+					const auto y2 = q.m_y[i] + q.m_y[i];
+					const auto z2 = q.m_z[i] + q.m_z[i];
+					const auto xx = q.m_x[i] * x2;
+					const auto yy = q.m_y[i] * y2;
+					const auto zz = q.m_z[i] * z2;
+					const auto xy = q.m_x[i] * y2;
+					const auto xz = q.m_x[i] * z2;
+					const auto yz = q.m_y[i] * z2;
+					const auto wx = q.m_w[i] * x2;
+					const auto wy = q.m_w[i] * y2;
+					const auto wz = q.m_w[i] * z2;
+
+					auto& m = out[i].m;
+					m[0][0] = (1.0f - yy - zz) * s.m_x[i];
+					m[0][1] = (xy - wz) * s.m_x[i];
+					m[0][2] = (xz + wy) * s.m_x[i];
+					m[0][3] = 0.0f;
+					m[1][0] = (xy + wz) * s.m_y[i];
+					m[1][1] = (1.0f - xx - zz) * s.m_y[i];
+					m[1][2] = (yz - wx) * s.m_y[i];
+					m[1][3] = 0.0f;
+					m[2][0] = (xz - wy) * s.m_z[i];
+					m[2][1] = (yz + wx) * s.m_z[i];
+					m[2][2] = (1.0f - xx - yy) * s.m_z[i];
+					m[2][3] = 0.0f;
+					m[3][0] = p.m_x[i];
+					m[3][1] = p.m_y[i];
+					m[3][2] = p.m_z[i];
+					m[3][3] = 1.0f;
+				}
+			}
+
+			auto TransformScalar(const oxyMat4x4& m,
+								 Vec3Streams<const oxyF32> in,
+								 Vec3Streams<oxyF32> out, oxyF32 w,
+								 oxySize count) -> void
+			{
+				const auto tx = m.m[3][0] * w;
+				const auto ty = m.m[3][1] * w;
+				const auto tz = m.m[3][2] * w;
+				for (oxySize i = 0; i < count; i++)
+				{
+					const auto x = in.m_x[i];
+					const auto y = in.m_y[i];
+					const auto z = in.m_z[i];
+					out.m_x[i] = x * m.m[0][0] + y * m.m[1][0] +
+								 z * m.m[2][0] + tx;
+					out.m_y[i] = x * m.m[0][1] + y * m.m[1][1] +
+								 z * m.m[2][1] + ty;
+					out.m_z[i] = x * m.m[0][2] + y * m.m[1][2] +
+								 z * m.m[2][2] + tz;
+				}
+			}
+
+			template <Accuracy A>
+			auto NormalizeScalar(Vec3Streams<const oxyF32> in,
+								 Vec3Streams<oxyF32> out, oxySize begin,
+								 oxySize end) -> void
+			{
+				for (oxySize i = begin; i < end; i++)
+				{
+					const auto x = in.m_x[i];
+					const auto y = in.m_y[i];
+					const auto z = in.m_z[i];
+					const auto inv = SafeRSqrt<A>(x * x + y * y + z * z);
+					out.m_x[i] = x * inv;
+					out.m_y[i] = y * inv;
+					out.m_z[i] = z * inv;
+				}
+			}
+
+			auto MultiplyDefault(const oxyMat4x4* a, const oxyMat4x4* b,
+								 oxyMat4x4* out, oxySize count) -> void
+			{
+				for (oxySize i = 0; i < count; i++)
+					Simd::Multiply4x4(&a[i].m[0][0], &b[i].m[0][0],
+									  &out[i].m[0][0]);
+			}
+
+			template <auto Blend>
+			auto QuatBlendScalar(const QuatBlendStreams& q, oxySize begin,
+								 oxySize end) -> void
+			{
+				const auto& a = q.m_a;
+				const auto& b = q.m_b;
+				for (oxySize i = begin; i < end; i++)
+				{
+					const auto r =
+						Blend({a.m_x[i], a.m_y[i], a.m_z[i], a.m_w[i]},
+							  {b.m_x[i], b.m_y[i], b.m_z[i], b.m_w[i]},
+							  q.m_t[i]);
+					q.m_out.m_x[i] = r.x;
+					q.m_out.m_y[i] = r.y;
+					q.m_out.m_z[i] = r.z;
+					q.m_out.m_w[i] = r.w;
+				}
+			}
+
+			/**
+			 * @brief Culls volumes [begin, end) and appends the visible ones
+			 * at visible + written.
+			 * @return New number of written indices
+			 */
+			auto CullSpheresScalar(const oxyFrustum& frustum,
+								   const SphereStreams& spheres,
+								   oxyU32* visible, oxySize begin, oxySize end,
+								   oxySize written) -> oxySize
+			{
+				const auto& c = spheres.m_center;
+				for (oxySize i = begin; i < end; i++)
+				{
+					const oxySphere sphere{{c.m_x[i], c.m_y[i], c.m_z[i]},
+										   spheres.m_radius[i]};
+					// Branchless append, the slot is overwritten if culled
+					visible[written] = static_cast<oxyU32>(i);
+					written += frustum.Intersects(sphere);
+				}
+				return written;
+			}
+			auto CullAABBsScalar(const oxyFrustum& frustum,
+								 const AABBStreams& boxes, oxyU32* visible,
+								 oxySize begin, oxySize end, oxySize written)
+				-> oxySize
+			{
+				const auto& c = boxes.m_center;
+				const auto& e = boxes.m_extents;
+				for (oxySize i = begin; i < end; i++)
+				{
+					const oxyAABB box{{c.m_x[i], c.m_y[i], c.m_z[i]},
+									  {e.m_x[i], e.m_y[i], e.m_z[i]}};
+					visible[written] = static_cast<oxyU32>(i);
+					written += frustum.Intersects(box);
+				}
+				return written;
+			}
+
+#ifdef OXYMATHBATCHAVX2
+			/**
+			 * @brief Lane j of the outputs gets element j of the inputs, so
+			 * eight streams become eight consecutive 8 float records.
+			 */
+			OXYTARGETAVX2 inline auto Transpose8x8(__m256 (&r)[8]) -> void
+			{
+				const auto t0 = _mm256_unpacklo_ps(r[0], r[1]);
+				const auto t1 = _mm256_unpackhi_ps(r[0], r[1]);
+				const auto t2 = _mm256_unpacklo_ps(r[2], r[3]);
+				const auto t3 = _mm256_unpackhi_ps(r[2], r[3]);
+				const auto t4 = _mm256_unpacklo_ps(r[4], r[5]);
+				const auto t5 = _mm256_unpackhi_ps(r[4], r[5]);
+				const auto t6 = _mm256_unpacklo_ps(r[6], r[7]);
+				const auto t7 = _mm256_unpackhi_ps(r[6], r[7]);
+				const auto u0 = _mm256_shuffle_ps(t0, t2, 0x44);
+				const auto u1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+				const auto u2 = _mm256_shuffle_ps(t1, t3, 0x44);
+				const auto u3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+				const auto u4 = _mm256_shuffle_ps(t4, t6, 0x44);
+				const auto u5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+				const auto u6 = _mm256_shuffle_ps(t5, t7, 0x44);
+				const auto u7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+				r[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+				r[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+				r[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+				r[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+				r[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+				r[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+				r[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+				r[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+			}
+
+			OXYTARGETAVX2 auto ComposeTRSAvx2(const TRSStreams& trs,
+											  oxyMat4x4* out, oxySize begin,
+											  oxySize end) -> void
+			{
+				const auto& p = trs.m_position;
+				const auto& q = trs.m_rotation;
+				const auto& s = trs.m_scale;
+				const auto zero = _mm256_setzero_ps();
+				const auto one = _mm256_set1_ps(1.0f);
+				auto i = begin;
+				for (; i + 8 <= end; i += 8)
+				{
+					const auto x = _mm256_loadu_ps(q.m_x + i);
+					const auto y = _mm256_loadu_ps(q.m_y + i);
+					const auto z = _mm256_loadu_ps(q.m_z + i);
+					const auto w = _mm256_loadu_ps(q.m_w + i);
+					const auto x2 = _mm256_add_ps(x, x);
+					const auto y2 = _mm256_add_ps(y, y);
+					const auto z2 = _mm256_add_ps(z, z);
+					const auto xx = _mm256_mul_ps(x, x2);
+					const auto yy = _mm256_mul_ps(y, y2);
+					const auto zz = _mm256_mul_ps(z, z2);
+					const auto xy = _mm256_mul_ps(x, y2);
+					const auto xz = _mm256_mul_ps(x, z2);
+					const auto yz = _mm256_mul_ps(y, z2);
+					const auto wx = _mm256_mul_ps(w, x2);
+					const auto wy = _mm256_mul_ps(w, y2);
+					const auto wz = _mm256_mul_ps(w, z2);
+					const auto sx = _mm256_loadu_ps(s.m_x + i);
+					const auto sy = _mm256_loadu_ps(s.m_y + i);
+					const auto sz = _mm256_loadu_ps(s.m_z + i);
+
+					// Rows 0 and 1 of eight matrices
+					__m256 r01[8]{
+						_mm256_mul_ps(
+							_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx),
+						_mm256_mul_ps(_mm256_sub_ps(xy, wz), sx),
+						_mm256_mul_ps(_mm256_add_ps(xz, wy), sx),
+						zero,
+						_mm256_mul_ps(_mm256_add_ps(xy, wz), sy),
+						_mm256_mul_ps(
+							_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy),
+						_mm256_mul_ps(_mm256_sub_ps(yz, wx), sy),
+						zero,
+					};
+					// Rows 2 and 3
+					__m256 r23[8]{
+						_mm256_mul_ps(_mm256_sub_ps(xz, wy), sz),
+						_mm256_mul_ps(_mm256_add_ps(yz, wx), sz),
+						_mm256_mul_ps(
+							_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz),
+						zero,
+						_mm256_loadu_ps(p.m_x + i),
+						_mm256_loadu_ps(p.m_y + i),
+						_mm256_loadu_ps(p.m_z + i),
+						one,
+					};
+					Transpose8x8(r01);
+					Transpose8x8(r23);
+					for (int j = 0; j < 8; j++)
+					{
+						_mm256_storeu_ps(&out[i + j].m[0][0], r01[j]);
+						_mm256_storeu_ps(&out[i + j].m[2][0], r23[j]);
+					}
+				}
+				_mm256_zeroupper();
+				ComposeTRSScalar(trs, out, i, end);
+			}
+
+			OXYTARGETAVX2 auto TransformAvx2(const oxyMat4x4& m,
+											 Vec3Streams<const oxyF32> in,
+											 Vec3Streams<oxyF32> out,
+											 oxyF32 w, oxySize count) -> void
+			{
+				const auto m00 = _mm256_set1_ps(m.m[0][0]);
+				const auto m01 = _mm256_set1_ps(m.m[0][1]);
+				const auto m02 = _mm256_set1_ps(m.m[0][2]);
+				const auto m10 = _mm256_set1_ps(m.m[1][0]);
+				const auto m11 = _mm256_set1_ps(m.m[1][1]);
+				const auto m12 = _mm256_set1_ps(m.m[1][2]);
+				const auto m20 = _mm256_set1_ps(m.m[2][0]);
+				const auto m21 = _mm256_set1_ps(m.m[2][1]);
+				const auto m22 = _mm256_set1_ps(m.m[2][2]);
+				const auto tx = _mm256_set1_ps(m.m[3][0] * w);
+				const auto ty = _mm256_set1_ps(m.m[3][1] * w);
+				const auto tz = _mm256_set1_ps(m.m[3][2] * w);
+				oxySize i = 0;
+				for (; i + 8 <= count; i += 8)
+				{
+					const auto x = _mm256_loadu_ps(in.m_x + i);
+					const auto y = _mm256_loadu_ps(in.m_y + i);
+					const auto z = _mm256_loadu_ps(in.m_z + i);
+					auto rx = _mm256_fmadd_ps(x, m00, tx);
+					auto ry = _mm256_fmadd_ps(x, m01, ty);
+					auto rz = _mm256_fmadd_ps(x, m02, tz);
+					rx = _mm256_fmadd_ps(y, m10, rx);
+					ry = _mm256_fmadd_ps(y, m11, ry);
+					rz = _mm256_fmadd_ps(y, m12, rz);
+					rx = _mm256_fmadd_ps(z, m20, rx);
+					ry = _mm256_fmadd_ps(z, m21, ry);
+					rz = _mm256_fmadd_ps(z, m22, rz);
+					_mm256_storeu_ps(out.m_x + i, rx);
+					_mm256_storeu_ps(out.m_y + i, ry);
+					_mm256_storeu_ps(out.m_z + i, rz);
+				}
+				_mm256_zeroupper();
+				in = {in.m_x + i, in.m_y + i, in.m_z + i};
+				out = {out.m_x + i, out.m_y + i, out.m_z + i};
+				TransformScalar(m, in, out, w, count - i);
+			}
+
+			/**
+			 * @brief Eight lane Simd::SafeRSqrt.
+			 */
+			template <Accuracy A>
+			OXYTARGETAVX2 inline auto SafeRSqrtAvx2(__m256 x) -> __m256
+			{
+				const auto valid = _mm256_cmp_ps(
+					x, _mm256_set1_ps(k_minLengthSquared), _CMP_GE_OQ);
+				__m256 r;
+				if constexpr (A == Accuracy::Fast)
+				{
+					const auto e = _mm256_rsqrt_ps(x);
+					const auto h = _mm256_mul_ps(
+						_mm256_mul_ps(x, _mm256_set1_ps(0.5f)), e);
+					r = _mm256_mul_ps(
+						e, _mm256_fnmadd_ps(h, e, _mm256_set1_ps(1.5f)));
+				}
+				else
+				{
+					r = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(x));
+				}
+				return _mm256_and_ps(r, valid);
+			}
+
+			template <Accuracy A>
+			OXYTARGETAVX2 auto NormalizeAvx2(Vec3Streams<const oxyF32> in,
+											 Vec3Streams<oxyF32> out,
+											 oxySize begin, oxySize end)
+				-> void
+			{
+				auto i = begin;
+				for (; i + 8 <= end; i += 8)
+				{
+					const auto x = _mm256_loadu_ps(in.m_x + i);
+					const auto y = _mm256_loadu_ps(in.m_y + i);
+					const auto z = _mm256_loadu_ps(in.m_z + i);
+					auto lengthSquared = _mm256_mul_ps(x, x);
+					lengthSquared = _mm256_fmadd_ps(y, y, lengthSquared);
+					lengthSquared = _mm256_fmadd_ps(z, z, lengthSquared);
+					const auto inv = SafeRSqrtAvx2<A>(lengthSquared);
+					_mm256_storeu_ps(out.m_x + i, _mm256_mul_ps(x, inv));
+					_mm256_storeu_ps(out.m_y + i, _mm256_mul_ps(y, inv));
+					_mm256_storeu_ps(out.m_z + i, _mm256_mul_ps(z, inv));
+				}
+				_mm256_zeroupper();
+				NormalizeScalar<A>(in, out, i, end);
+			}
+
+			/**
+			 * @brief One row of a * b for two rows of a at once, one in each
+			 * 128-bit half.
+			 */
+			OXYTARGETAVX2 inline auto MultiplyRowsAvx2(__m256 a, __m256 b0,
+													   __m256 b1, __m256 b2,
+													   __m256 b3) -> __m256
+			{
+				auto r = _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x00), b0);
+				r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, 0x55), b1, r);
+				r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, 0xAA), b2, r);
+				return _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, 0xFF), b3, r);
+			}
+
+			OXYTARGETAVX2 auto MultiplyAvx2(const oxyMat4x4* a,
+											const oxyMat4x4* b,
+											oxyMat4x4* out, oxySize count)
+				-> void
+			{
+				for (oxySize i = 0; i < count; i++)
+				{
+					const auto* bm = &b[i].m[0][0];
+					const auto b0 = _mm256_broadcast_ps(
+						reinterpret_cast<const __m128*>(bm + 0));
+					const auto b1 = _mm256_broadcast_ps(
+						reinterpret_cast<const __m128*>(bm + 4));
+					const auto b2 = _mm256_broadcast_ps(
+						reinterpret_cast<const __m128*>(bm + 8));
+					const auto b3 = _mm256_broadcast_ps(
+						reinterpret_cast<const __m128*>(bm + 12));
+					const auto a01 = _mm256_loadu_ps(&a[i].m[0][0]);
+					const auto a23 = _mm256_loadu_ps(&a[i].m[2][0]);
+					const auto r01 = MultiplyRowsAvx2(a01, b0, b1, b2, b3);
+					const auto r23 = MultiplyRowsAvx2(a23, b0, b1, b2, b3);
+					_mm256_storeu_ps(&out[i].m[0][0], r01);
+					_mm256_storeu_ps(&out[i].m[2][0], r23);
+				}
+				_mm256_zeroupper();
+			}
+
+			struct QuatAvx2
+			{
+				__m256 m_x, m_y, m_z, m_w;
+			};
+
+			OXYTARGETAVX2 inline auto LoadQuatAvx2(QuatStreams<const oxyF32> q,
+												   oxySize i) -> QuatAvx2
+			{
+				return {_mm256_loadu_ps(q.m_x + i), _mm256_loadu_ps(q.m_y + i),
+						_mm256_loadu_ps(q.m_z + i), _mm256_loadu_ps(q.m_w + i)};
+			}
+			OXYTARGETAVX2 inline auto StoreQuatAvx2(QuatStreams<oxyF32> q,
+													oxySize i,
+													const QuatAvx2& v) -> void
+			{
+				_mm256_storeu_ps(q.m_x + i, v.m_x);
+				_mm256_storeu_ps(q.m_y + i, v.m_y);
+				_mm256_storeu_ps(q.m_z + i, v.m_z);
+				_mm256_storeu_ps(q.m_w + i, v.m_w);
+			}
+			OXYTARGETAVX2 inline auto DotAvx2(const QuatAvx2& a,
+											  const QuatAvx2& b) -> __m256
+			{
+				auto r = _mm256_mul_ps(a.m_x, b.m_x);
+				r = _mm256_fmadd_ps(a.m_y, b.m_y, r);
+				r = _mm256_fmadd_ps(a.m_z, b.m_z, r);
+				return _mm256_fmadd_ps(a.m_w, b.m_w, r);
+			}
+			/**
+			 * @brief a * wa + b * wb
+			 */
+			OXYTARGETAVX2 inline auto BlendAvx2(const QuatAvx2& a,
+												const QuatAvx2& b, __m256 wa,
+												__m256 wb) -> QuatAvx2
+			{
+				return {
+					_mm256_fmadd_ps(b.m_x, wb, _mm256_mul_ps(a.m_x, wa)),
+					_mm256_fmadd_ps(b.m_y, wb, _mm256_mul_ps(a.m_y, wa)),
+					_mm256_fmadd_ps(b.m_z, wb, _mm256_mul_ps(a.m_z, wa)),
+					_mm256_fmadd_ps(b.m_w, wb, _mm256_mul_ps(a.m_w, wa)),
+				};
+			}
+
+			OXYTARGETAVX2 auto NlerpAvx2(const QuatBlendStreams& q,
+										 oxySize begin, oxySize end) -> void
+			{
+				const auto signMask = _mm256_set1_ps(-0.0f);
+				const auto one = _mm256_set1_ps(1.0f);
+				auto i = begin;
+				for (; i + 8 <= end; i += 8)
+				{
+					const auto a = LoadQuatAvx2(q.m_a, i);
+					const auto b = LoadQuatAvx2(q.m_b, i);
+					const auto t = _mm256_loadu_ps(q.m_t + i);
+					// Shorter arc: b takes the sign of the dot product
+					const auto sign = _mm256_and_ps(DotAvx2(a, b), signMask);
+					const auto wa = _mm256_sub_ps(one, t);
+					const auto wb = _mm256_xor_ps(t, sign);
+					auto r = BlendAvx2(a, b, wa, wb);
+					const auto invLength =
+						_mm256_div_ps(one, _mm256_sqrt_ps(DotAvx2(r, r)));
+					r.m_x = _mm256_mul_ps(r.m_x, invLength);
+					r.m_y = _mm256_mul_ps(r.m_y, invLength);
+					r.m_z = _mm256_mul_ps(r.m_z, invLength);
+					r.m_w = _mm256_mul_ps(r.m_w, invLength);
+					StoreQuatAvx2(q.m_out, i, r);
+				}
+				_mm256_zeroupper();
+				QuatBlendScalar<&Nlerp>(q, i, end);
+			}
+
+			/**
+			 * @brief Eight lane form of one weight of Math::SlerpWeights.
+			 */
+			OXYTARGETAVX2 inline auto SlerpWeightAvx2(__m256 t,
+													  __m256 cosThetaMinusOne)
+				-> __m256
+			{
+				const auto one = _mm256_set1_ps(1.0f);
+				const auto t2 = _mm256_mul_ps(t, t);
+				auto r = one;
+				for (int i = 7; i >= 0; i--)
+				{
+					const auto c = _mm256_fmsub_ps(_mm256_set1_ps(k_slerpU[i]),
+												   t2,
+												   _mm256_set1_ps(k_slerpV[i]));
+					r = _mm256_fmadd_ps(_mm256_mul_ps(c, cosThetaMinusOne), r,
+										one);
+				}
+				return _mm256_mul_ps(t, r);
+			}
+
+			OXYTARGETAVX2 auto SlerpFastAvx2(const QuatBlendStreams& q,
+											 oxySize begin, oxySize end)
+				-> void
+			{
+				const auto signMask = _mm256_set1_ps(-0.0f);
+				const auto one = _mm256_set1_ps(1.0f);
+				auto i = begin;
+				for (; i + 8 <= end; i += 8)
+				{
+					const auto a = LoadQuatAvx2(q.m_a, i);
+					const auto b = LoadQuatAvx2(q.m_b, i);
+					const auto t = _mm256_loadu_ps(q.m_t + i);
+					const auto cosTheta = DotAvx2(a, b);
+					const auto sign = _mm256_and_ps(cosTheta, signMask);
+					const auto x = _mm256_sub_ps(
+						_mm256_andnot_ps(signMask, cosTheta), one);
+					const auto wa = SlerpWeightAvx2(_mm256_sub_ps(one, t), x);
+					const auto wb =
+						_mm256_xor_ps(SlerpWeightAvx2(t, x), sign);
+					StoreQuatAvx2(q.m_out, i, BlendAvx2(a, b, wa, wb));
+				}
+				_mm256_zeroupper();
+				QuatBlendScalar<&SlerpFast>(q, i, end);
+			}
+
+			// Lane indices of the set bits of each 8 bit mask, packed as
+			// bytes, to compact visible indices with one permute
+			constexpr auto k_compactTable = [] {
+				std::array<oxyU64, 256> table{};
+				for (oxyU32 mask = 0; mask < 256; mask++)
+				{
+					oxyU32 count = 0;
+					for (oxyU32 lane = 0; lane < 8; lane++)
+					{
+						if (mask & (1u << lane))
+							table[mask] |= oxyU64{lane} << (8 * count++);
+					}
+				}
+				return table;
+			}();
+
+			struct PlanesAvx2
+			{
+				__m256 m_x[6], m_y[6], m_z[6], m_w[6];
+			};
+
+			OXYTARGETAVX2 inline auto LoadPlanesAvx2(const oxyFrustum& frustum)
+				-> PlanesAvx2
+			{
+				PlanesAvx2 planes;
+				for (int p = 0; p < 6; p++)
+				{
+					planes.m_x[p] = _mm256_set1_ps(frustum.planes[p].x);
+					planes.m_y[p] = _mm256_set1_ps(frustum.planes[p].y);
+					planes.m_z[p] = _mm256_set1_ps(frustum.planes[p].z);
+					planes.m_w[p] = _mm256_set1_ps(frustum.planes[p].w);
+				}
+				return planes;
+			}
+
+			/**
+			 * @brief Appends base + lane for every set bit of mask.
+			 */
+			OXYTARGETAVX2 inline auto AppendVisibleAvx2(oxyU32* visible,
+														oxySize written,
+														oxySize base,
+														int mask) -> oxySize
+			{
+				const auto lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+					reinterpret_cast<const __m128i*>(&k_compactTable[mask])));
+				const auto indices = _mm256_add_epi32(
+					lanes, _mm256_set1_epi32(static_cast<int>(base)));
+				_mm256_storeu_si256(
+					reinterpret_cast<__m256i*>(visible + written), indices);
+				return written + std::popcount(static_cast<oxyU32>(mask));
+			}
+
+			OXYTARGETAVX2 auto CullSpheresAvx2(const oxyFrustum& frustum,
+											   const SphereStreams& spheres,
+											   oxyU32* visible, oxySize begin,
+											   oxySize end, oxySize written)
+				-> oxySize
+			{
+				const auto planes = LoadPlanesAvx2(frustum);
+				const auto zero = _mm256_setzero_ps();
+				const auto& c = spheres.m_center;
+				auto i = begin;
+				for (; i + 8 <= end; i += 8)
+				{
+					const auto x = _mm256_loadu_ps(c.m_x + i);
+					const auto y = _mm256_loadu_ps(c.m_y + i);
+					const auto z = _mm256_loadu_ps(c.m_z + i);
+					const auto r = _mm256_loadu_ps(spheres.m_radius + i);
+					const auto minDistance = _mm256_sub_ps(zero, r);
+					auto inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+					for (int p = 0; p < 6; p++)
+					{
+						auto d = _mm256_fmadd_ps(x, planes.m_x[p],
+												 planes.m_w[p]);
+						d = _mm256_fmadd_ps(y, planes.m_y[p], d);
+						d = _mm256_fmadd_ps(z, planes.m_z[p], d);
+						const auto test =
+							_mm256_cmp_ps(d, minDistance, _CMP_GE_OQ);
+						inside = _mm256_and_ps(inside, test);
+					}
+					written = AppendVisibleAvx2(visible, written, i,
+												_mm256_movemask_ps(inside));
+				}
+				_mm256_zeroupper();
+				return CullSpheresScalar(frustum, spheres, visible, i, end,
+										 written);
+			}
+
+			OXYTARGETAVX2 auto CullAABBsAvx2(const oxyFrustum& frustum,
+											 const AABBStreams& boxes,
+											 oxyU32* visible, oxySize begin,
+											 oxySize end, oxySize written)
+				-> oxySize
+			{
+				const auto planes = LoadPlanesAvx2(frustum);
+				const auto zero = _mm256_setzero_ps();
+				// Absolute normals give the half extent of a box along them
+				const auto signMask = _mm256_set1_ps(-0.0f);
+				__m256 absX[6], absY[6], absZ[6];
+				for (int p = 0; p < 6; p++)
+				{
+					absX[p] = _mm256_andnot_ps(signMask, planes.m_x[p]);
+					absY[p] = _mm256_andnot_ps(signMask, planes.m_y[p]);
+					absZ[p] = _mm256_andnot_ps(signMask, planes.m_z[p]);
+				}
+				const auto& c = boxes.m_center;
+				const auto& e = boxes.m_extents;
+				auto i = begin;
+				for (; i + 8 <= end; i += 8)
+				{
+					const auto x = _mm256_loadu_ps(c.m_x + i);
+					const auto y = _mm256_loadu_ps(c.m_y + i);
+					const auto z = _mm256_loadu_ps(c.m_z + i);
+					const auto ex = _mm256_loadu_ps(e.m_x + i);
+					const auto ey = _mm256_loadu_ps(e.m_y + i);
+					const auto ez = _mm256_loadu_ps(e.m_z + i);
+					auto inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+					for (int p = 0; p < 6; p++)
+					{
+						auto r = _mm256_mul_ps(ex, absX[p]);
+						r = _mm256_fmadd_ps(ey, absY[p], r);
+						r = _mm256_fmadd_ps(ez, absZ[p], r);
+						auto d = _mm256_fmadd_ps(x, planes.m_x[p], r);
+						d = _mm256_fmadd_ps(y, planes.m_y[p], d);
+						d = _mm256_fmadd_ps(z, planes.m_z[p], d);
+						d = _mm256_add_ps(d, planes.m_w[p]);
+						const auto test = _mm256_cmp_ps(d, zero, _CMP_GE_OQ);
+						inside = _mm256_and_ps(inside, test);
+					}
+					written = AppendVisibleAvx2(visible, written, i,
+												_mm256_movemask_ps(inside));
+				}
+				_mm256_zeroupper();
+				return CullAABBsScalar(frustum, boxes, visible, i, end,
+									   written);
+			}
+#endif
+
+			auto SelectKernels() -> BatchKernels
+			{
+				BatchKernels kernels{&ComposeTRSScalar,
+									 &TransformScalar,
+									 &NormalizeScalar<Accuracy::Exact>,
+									 &NormalizeScalar<Accuracy::Fast>,
+									 &MultiplyDefault,
+									 &QuatBlendScalar<&Nlerp>,
+									 &QuatBlendScalar<&SlerpFast>,
+									 &CullSpheresScalar,
+									 &CullAABBsScalar,
+									 "scalar"};
+#ifdef OXYMATHBATCHAVX2
+				const auto& cpu = GetCpuFeatures();
+				if (cpu.m_avx2 && cpu.m_fma)
+					kernels = {&ComposeTRSAvx2,
+							   &TransformAvx2,
+							   &NormalizeAvx2<Accuracy::Exact>,
+							   &NormalizeAvx2<Accuracy::Fast>,
+							   &MultiplyAvx2,
+							   &NlerpAvx2,
+							   &SlerpFastAvx2,
+							   &CullSpheresAvx2,
+							   &CullAABBsAvx2,
+							   "avx2"};
+#endif
+				return kernels;
+			}
+
+			auto GetKernels() -> const BatchKernels&
+			{
+				static const BatchKernels kernels = SelectKernels();
+				return kernels;
+			}
+		}; // namespace
+
+		auto ComposeTRSBatch(const TRSStreams& trs, oxyMat4x4* out,
+							 oxySize count) -> void
+		{
+			GetKernels().m_composeTRS(trs, out, 0, count);
+		}
+
+		auto TransformPointsBatch(const oxyMat4x4& m,
+								  Vec3Streams<const oxyF32> in,
+								  Vec3Streams<oxyF32> out, oxySize count)
+			-> void
+		{
+			GetKernels().m_transform(m, in, out, 1.0f, count);
+		}
+
+		auto TransformDirectionsBatch(const oxyMat4x4& m,
+									  Vec3Streams<const oxyF32> in,
+									  Vec3Streams<oxyF32> out, oxySize count)
+			-> void
+		{
+			GetKernels().m_transform(m, in, out, 0.0f, count);
+		}
+
+		auto NormalizeBatch(Vec3Streams<const oxyF32> in,
+							Vec3Streams<oxyF32> out, oxySize count,
+							Accuracy accuracy) -> void
+		{
+			const auto& kernels = GetKernels();
+			if (accuracy == Accuracy::Fast)
+				kernels.m_normalizeFast(in, out, 0, count);
+			else
+				kernels.m_normalize(in, out, 0, count);
+		}
+
+		auto MultiplyBatch(const oxyMat4x4* a, const oxyMat4x4* b,
+						   oxyMat4x4* out, oxySize count) -> void
+		{
+			GetKernels().m_multiply(a, b, out, count);
+		}
+
+		auto InverseBatch(const oxyMat4x4* a, oxyMat4x4* out, oxySize count)
+			-> void
+		{
+			for (oxySize i = 0; i < count; i++)
+				Simd::Inverse4x4(a[i].m[0], out[i].m[0]);
+		}
+
+		auto InverseAffineBatch(const oxyMat4x4* a, oxyMat4x4* out,
+								oxySize count) -> void
+		{
+			for (oxySize i = 0; i < count; i++)
+				out[i] = InverseAffine(a[i]);
+		}
+
+		auto InverseTransposeBatch(const oxyMat4x4* a, oxyMat4x4* out,
+								   oxySize count) -> void
+		{
+			for (oxySize i = 0; i < count; i++)
+				out[i] = InverseTranspose(a[i]);
+		}
+
+		auto NlerpBatch(const QuatBlendStreams& q, oxySize count) -> void
+		{
+			GetKernels().m_nlerp(q, 0, count);
+		}
+
+		auto SlerpBatch(const QuatBlendStreams& q, oxySize count) -> void
+		{
+			QuatBlendScalar<&Slerp>(q, 0, count);
+		}
+
+		auto SlerpFastBatch(const QuatBlendStreams& q, oxySize count) -> void
+		{
+			GetKernels().m_slerpFast(q, 0, count);
+		}
+
+		auto CullSpheresBatch(const oxyFrustum& frustum,
+							  const SphereStreams& spheres, oxyU32* visible,
+							  oxySize count) -> oxySize
+		{
+			return GetKernels().m_cullSpheres(frustum, spheres, visible, 0,
+											  count, 0);
+		}
+
+		auto CullAABBsBatch(const oxyFrustum& frustum, const AABBStreams& boxes,
+							oxyU32* visible, oxySize count) -> oxySize
+		{
+			return GetKernels().m_cullAABBs(frustum, boxes, visible, 0, count,
+											0);
+		}
+
+		auto GetBatchBackendName() -> std::string_view
+		{
+			return GetKernels().m_backend;
+		}
+	}; // namespace Math
+}; // namespace oxygen
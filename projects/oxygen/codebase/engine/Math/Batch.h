@@ -0,0 +1,138 @@
+#pragma once
+
+namespace oxygen
+{
+	namespace Math
+	{
+		/**
+		 * @brief Structure of arrays view of N vectors, one stream per
+		 * component. Streams need no particular alignment.
+		 */
+		template <typename T> struct Vec3Streams
+		{
+			T* m_x{};
+			T* m_y{};
+			T* m_z{};
+		};
+		template <typename T> struct QuatStreams
+		{
+			T* m_x{};
+			T* m_y{};
+			T* m_z{};
+			T* m_w{};
+		};
+
+		/**
+		 * @brief Blends N rotation pairs, out[i] = blend(a[i], b[i], t[i]).
+		 * out may alias a or b.
+		 */
+		struct QuatBlendStreams
+		{
+			QuatStreams<const oxyF32> m_a{};
+			QuatStreams<const oxyF32> m_b{};
+			const oxyF32* m_t{};
+			QuatStreams<oxyF32> m_out{};
+		};
+
+		/**
+		 * @brief Bounding volumes of N objects for culling.
+		 */
+		struct SphereStreams
+		{
+			Vec3Streams<const oxyF32> m_center{};
+			const oxyF32* m_radius{};
+		};
+		struct AABBStreams
+		{
+			Vec3Streams<const oxyF32> m_center{};
+			Vec3Streams<const oxyF32> m_extents{};
+		};
+
+		/**
+		 * @brief Position, rotation and scale of N transforms, as stored per
+		 * entity but split into streams.
+		 */
+		struct TRSStreams
+		{
+			Vec3Streams<const oxyF32> m_position{};
+			QuatStreams<const oxyF32> m_rotation{};
+			Vec3Streams<const oxyF32> m_scale{};
+		};
+
+		/**
+		 * @brief out[i] = Scale(I, s) * Rotate(I, q) with the translation
+		 * written to row 3, so v' = v * S * R * T. Rotations are expected to
+		 * be normalized.
+		 */
+		auto ComposeTRSBatch(const TRSStreams& trs, oxyMat4x4* out,
+							 oxySize count) -> void;
+
+		/**
+		 * @brief Transforms N points as rows (x, y, z, 1) by an affine
+		 * matrix. The w column of m is ignored. out may alias in.
+		 */
+		auto TransformPointsBatch(const oxyMat4x4& m,
+								  Vec3Streams<const oxyF32> in,
+								  Vec3Streams<oxyF32> out, oxySize count)
+			-> void;
+		/**
+		 * @brief Same as TransformPointsBatch without the translation, for
+		 * directions (x, y, z, 0).
+		 */
+		auto TransformDirectionsBatch(const oxyMat4x4& m,
+									  Vec3Streams<const oxyF32> in,
+									  Vec3Streams<oxyF32> out, oxySize count)
+			-> void;
+
+		/**
+		 * @brief out[i] = in[i].SafeNormalized<accuracy>(), zero length
+		 * vectors become zero. out may alias in.
+		 */
+		auto NormalizeBatch(Vec3Streams<const oxyF32> in,
+							Vec3Streams<oxyF32> out, oxySize count,
+							Accuracy accuracy = k_defaultAccuracy) -> void;
+
+		/**
+		 * @brief out[i] = a[i] * b[i]. out may alias a or b.
+		 */
+		auto MultiplyBatch(const oxyMat4x4* a, const oxyMat4x4* b,
+						   oxyMat4x4* out, oxySize count) -> void;
+
+		/**
+		 * @brief out[i] = a[i].Inversed(), Math::InverseAffine(a[i]) and
+		 * Math::InverseTranspose(a[i]). out may alias a.
+		 */
+		auto InverseBatch(const oxyMat4x4* a, oxyMat4x4* out, oxySize count)
+			-> void;
+		auto InverseAffineBatch(const oxyMat4x4* a, oxyMat4x4* out,
+								oxySize count) -> void;
+		auto InverseTransposeBatch(const oxyMat4x4* a, oxyMat4x4* out,
+								   oxySize count) -> void;
+
+		/**
+		 * @brief Math::Nlerp, Math::Slerp and Math::SlerpFast over N pairs.
+		 * Only Nlerp and SlerpFast have wide kernels.
+		 */
+		auto NlerpBatch(const QuatBlendStreams& q, oxySize count) -> void;
+		auto SlerpBatch(const QuatBlendStreams& q, oxySize count) -> void;
+		auto SlerpFastBatch(const QuatBlendStreams& q, oxySize count) -> void;
+
+		/**
+		 * @brief Writes the indices of the volumes passing
+		 * oxyFrustum::Intersects to visible, in increasing order.
+		 * @param visible Room for count indices.
+		 * @return Number of visible volumes
+		 */
+		auto CullSpheresBatch(const oxyFrustum& frustum,
+							  const SphereStreams& spheres, oxyU32* visible,
+							  oxySize count) -> oxySize;
+		auto CullAABBsBatch(const oxyFrustum& frustum, const AABBStreams& boxes,
+							oxyU32* visible, oxySize count) -> oxySize;
+
+		/**
+		 * @brief Instruction set of the kernels selected for this CPU, "avx2"
+		 * or "scalar".
+		 */
+		auto GetBatchBackendName() -> std::string_view;
+	}; // namespace Math
+}; // namespace oxygen
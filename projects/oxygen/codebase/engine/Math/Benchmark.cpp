@@ -0,0 +1,1402 @@
+#include "OxygenPCH.h"
+#include "Math/Benchmark.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "Math/Batch.h"
+
+namespace oxygen
+{
+	namespace Math
+	{
+		namespace
+		{
+			// Plain implementations, instantiated with float as the baseline
+			// the library is timed against and with double as the exact
+			// result the errors are measured from. Quaternions use RefVec4.
+			template <typename T> struct RefVec3
+			{
+				T x, y, z;
+			};
+			template <typename T> struct RefVec4
+			{
+				T x, y, z, w;
+			};
+			template <typename T> struct RefMat4x4
+			{
+				T m[4][4];
+			};
+
+			template <typename T> auto ToRef(const oxyVec3& v) -> RefVec3<T>
+			{
+				return {v.x, v.y, v.z};
+			}
+			template <typename T> auto ToRef(const oxyVec4& v) -> RefVec4<T>
+			{
+				return {v.x, v.y, v.z, v.w};
+			}
+			template <typename T> auto ToRef(const oxyQuat& q) -> RefVec4<T>
+			{
+				return {q.x, q.y, q.z, q.w};
+			}
+			template <typename T>
+			auto ToRef(const oxyMat4x4& a) -> RefMat4x4<T>
+			{
+				RefMat4x4<T> result{};
+				for (int i = 0; i < 4; i++)
+				{
+					for (int j = 0; j < 4; j++)
+						result.m[i][j] = a.m[i][j];
+				}
+				return result;
+			}
+
+			template <typename T>
+			auto Add(const RefVec3<T>& a, const RefVec3<T>& b) -> RefVec3<T>
+			{
+				return {a.x + b.x, a.y + b.y, a.z + b.z};
+			}
+			template <typename T>
+			auto Sub(const RefVec3<T>& a, const RefVec3<T>& b) -> RefVec3<T>
+			{
+				return {a.x - b.x, a.y - b.y, a.z - b.z};
+			}
+			template <typename T>
+			auto Dot(const RefVec3<T>& a, const RefVec3<T>& b) -> T
+			{
+				return a.x * b.x + a.y * b.y + a.z * b.z;
+			}
+			template <typename T>
+			auto Cross(const RefVec3<T>& a, const RefVec3<T>& b) -> RefVec3<T>
+			{
+				return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z,
+						a.x * b.y - a.y * b.x};
+			}
+			template <typename T>
+			auto Normalize(const RefVec3<T>& a) -> RefVec3<T>
+			{
+				const auto length = std::sqrt(Dot(a, a));
+				return {a.x / length, a.y / length, a.z / length};
+			}
+
+			template <typename T>
+			auto Dot(const RefVec4<T>& a, const RefVec4<T>& b) -> T
+			{
+				return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+			}
+			template <typename T>
+			auto Mul(const RefVec4<T>& a, const RefVec4<T>& b) -> RefVec4<T>
+			{
+				return {a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w};
+			}
+
+			template <typename T>
+			auto Multiply(const RefMat4x4<T>& a, const RefMat4x4<T>& b)
+				-> RefMat4x4<T>
+			{
+				RefMat4x4<T> result{};
+				for (int i = 0; i < 4; i++)
+				{
+					for (int j = 0; j < 4; j++)
+					{
+						for (int k = 0; k < 4; k++)
+							result.m[i][j] += a.m[i][k] * b.m[k][j];
+					}
+				}
+				return result;
+			}
+			/**
+			 * @brief v * m, as operator*(oxyMat4x4, oxyVec4).
+			 */
+			template <typename T>
+			auto Transform(const RefMat4x4<T>& m, const RefVec4<T>& v)
+				-> RefVec4<T>
+			{
+				T r[4]{};
+				for (int j = 0; j < 4; j++)
+				{
+					r[j] = v.x * m.m[0][j] + v.y * m.m[1][j] +
+						   v.z * m.m[2][j] + v.w * m.m[3][j];
+				}
+				return {r[0], r[1], r[2], r[3]};
+			}
+			template <typename T>
+			auto TransformPoint(const RefMat4x4<T>& m, const RefVec3<T>& p)
+				-> RefVec3<T>
+			{
+				const auto r = Transform(m, RefVec4<T>{p.x, p.y, p.z, 1});
+				return {r.x, r.y, r.z};
+			}
+
+			template <typename T>
+			auto LookAt(const RefVec3<T>& eye, const RefVec3<T>& center,
+						const RefVec3<T>& up) -> RefMat4x4<T>
+			{
+				const auto f = Normalize(Sub(center, eye));
+				const auto s = Normalize(Cross(f, up));
+				const auto u = Cross(s, f);
+				return {{{s.x, u.x, -f.x, 0},
+						 {s.y, u.y, -f.y, 0},
+						 {s.z, u.z, -f.z, 0},
+						 {-Dot(s, eye), -Dot(u, eye), Dot(f, eye), 1}}};
+			}
+			template <typename T>
+			auto Perspective(T fovy, T aspect, T near, T far) -> RefMat4x4<T>
+			{
+				const auto t = std::tan(fovy / 2);
+				RefMat4x4<T> result{};
+				result.m[0][0] = 1 / (aspect * t);
+				result.m[1][1] = 1 / t;
+				result.m[2][2] = far / (far - near);
+				result.m[2][3] = 1;
+				result.m[3][2] = -(far * near) / (far - near);
+				return result;
+			}
+			/**
+			 * @brief Gauss-Jordan elimination with partial pivoting.
+			 */
+			template <typename T>
+			auto Inverse(RefMat4x4<T> a) -> RefMat4x4<T>
+			{
+				RefMat4x4<T> result{};
+				for (int i = 0; i < 4; i++)
+					result.m[i][i] = 1;
+				for (int c = 0; c < 4; c++)
+				{
+					auto pivot = c;
+					for (int r = c + 1; r < 4; r++)
+					{
+						if (std::fabs(a.m[r][c]) > std::fabs(a.m[pivot][c]))
+							pivot = r;
+					}
+					std::swap(a.m[c], a.m[pivot]);
+					std::swap(result.m[c], result.m[pivot]);
+					const auto scale = 1 / a.m[c][c];
+					for (int j = 0; j < 4; j++)
+					{
+						a.m[c][j] *= scale;
+						result.m[c][j] *= scale;
+					}
+					for (int r = 0; r < 4; r++)
+					{
+						if (r == c)
+							continue;
+						const auto f = a.m[r][c];
+						for (int j = 0; j < 4; j++)
+						{
+							a.m[r][j] -= f * a.m[c][j];
+							result.m[r][j] -= f * result.m[c][j];
+						}
+					}
+				}
+				return result;
+			}
+			/**
+			 * @brief Transposed adjugate of the upper 3x3 over its
+			 * determinant, the translation row cleared.
+			 */
+			template <typename T>
+			auto InverseTranspose(const RefMat4x4<T>& a) -> RefMat4x4<T>
+			{
+				const RefVec3<T> r0{a.m[0][0], a.m[0][1], a.m[0][2]};
+				const RefVec3<T> r1{a.m[1][0], a.m[1][1], a.m[1][2]};
+				const RefVec3<T> r2{a.m[2][0], a.m[2][1], a.m[2][2]};
+				const auto c0 = Cross(r1, r2);
+				const auto c1 = Cross(r2, r0);
+				const auto c2 = Cross(r0, r1);
+				const auto invDet = 1 / Dot(r0, c0);
+				return {{{c0.x * invDet, c0.y * invDet, c0.z * invDet, 0},
+						 {c1.x * invDet, c1.y * invDet, c1.z * invDet, 0},
+						 {c2.x * invDet, c2.y * invDet, c2.z * invDet, 0},
+						 {0, 0, 0, 1}}};
+			}
+			template <typename T>
+			auto InverseAffine(const RefMat4x4<T>& a) -> RefMat4x4<T>
+			{
+				const auto t = InverseTranspose(a);
+				RefMat4x4<T> result{};
+				for (int i = 0; i < 3; i++)
+				{
+					for (int j = 0; j < 3; j++)
+					{
+						result.m[i][j] = t.m[j][i];
+						result.m[3][j] -= a.m[3][i] * t.m[j][i];
+					}
+				}
+				result.m[3][3] = 1;
+				return result;
+			}
+			/**
+			 * @brief Transpose of the upper 3x3, the rest cleared to identity.
+			 */
+			template <typename T>
+			auto TransposeUpper3x3(const RefMat4x4<T>& a) -> RefMat4x4<T>
+			{
+				RefMat4x4<T> result{};
+				for (int i = 0; i < 3; i++)
+				{
+					for (int j = 0; j < 3; j++)
+						result.m[i][j] = a.m[j][i];
+				}
+				result.m[3][3] = 1;
+				return result;
+			}
+
+			template <typename T>
+			auto QuatMultiply(const RefVec4<T>& a, const RefVec4<T>& b)
+				-> RefVec4<T>
+			{
+				return {a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+						a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+						a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+						a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+			}
+			/**
+			 * @brief q * v * conjugate(q), written out as two products.
+			 */
+			template <typename T>
+			auto QuatRotate(const RefVec4<T>& q, const RefVec3<T>& v)
+				-> RefVec3<T>
+			{
+				const auto p = QuatMultiply(q, RefVec4<T>{v.x, v.y, v.z, 0});
+				const RefVec4<T> conjugate{-q.x, -q.y, -q.z, q.w};
+				const auto r = QuatMultiply(p, conjugate);
+				return {r.x, r.y, r.z};
+			}
+			template <typename T>
+			auto EulerToQuat(const RefVec3<T>& e) -> RefVec4<T>
+			{
+				const RefVec4<T> pitch{std::sin(e.x / 2), 0, 0,
+									   std::cos(e.x / 2)};
+				const RefVec4<T> yaw{0, std::sin(e.y / 2), 0,
+									 std::cos(e.y / 2)};
+				const RefVec4<T> roll{0, 0, std::sin(e.z / 2),
+									  std::cos(e.z / 2)};
+				return QuatMultiply(QuatMultiply(pitch, yaw), roll);
+			}
+			template <typename T>
+			auto QuatToEuler(const RefVec4<T>& q) -> RefVec3<T>
+			{
+				return {std::atan2(2 * (q.w * q.x + q.y * q.z),
+								   1 - 2 * (q.x * q.x + q.y * q.y)),
+						std::asin(2 * (q.w * q.y - q.z * q.x)),
+						std::atan2(2 * (q.w * q.z + q.x * q.y),
+								   1 - 2 * (q.y * q.y + q.z * q.z))};
+			}
+
+			/**
+			 * @brief a * wa + b * wb, b flipped onto the shorter arc.
+			 */
+			template <typename T>
+			auto QuatBlend(const RefVec4<T>& a, const RefVec4<T>& b, T wa,
+						   T wb) -> RefVec4<T>
+			{
+				if (Dot(a, b) < 0)
+					wb = -wb;
+				return {a.x * wa + b.x * wb, a.y * wa + b.y * wb,
+						a.z * wa + b.z * wb, a.w * wa + b.w * wb};
+			}
+			template <typename T>
+			auto QuatNlerp(const RefVec4<T>& a, const RefVec4<T>& b, T t)
+				-> RefVec4<T>
+			{
+				const auto r = QuatBlend(a, b, 1 - t, t);
+				const auto length = std::sqrt(Dot(r, r));
+				return {r.x / length, r.y / length, r.z / length,
+						r.w / length};
+			}
+			template <typename T>
+			auto QuatSlerp(const RefVec4<T>& a, const RefVec4<T>& b, T t)
+				-> RefVec4<T>
+			{
+				const auto cosTheta = std::min<T>(std::fabs(Dot(a, b)), 1);
+				const auto theta = std::acos(cosTheta);
+				const auto sinTheta = std::sin(theta);
+				if (sinTheta < std::numeric_limits<T>::epsilon())
+					return QuatNlerp(a, b, t);
+				return QuatBlend(a, b, std::sin((1 - t) * theta) / sinTheta,
+								 std::sin(t * theta) / sinTheta);
+			}
+
+			struct PerspectiveInput
+			{
+				oxyF32 m_fovy, m_aspect, m_near, m_far;
+			};
+
+			/**
+			 * @brief Largest error of out against exact, per output relative
+			 * to its largest exact component.
+			 */
+			template <typename Out, typename Exact>
+			auto MaxRelativeError(const std::vector<Out>& out,
+								  const std::vector<Exact>& exact) -> oxyF64
+			{
+				constexpr auto n = sizeof(Exact) / sizeof(oxyF64);
+				static_assert(sizeof(Out) == n * sizeof(oxyF32));
+				oxyF64 maxError{};
+				for (oxySize i = 0; i < out.size(); i++)
+				{
+					oxyF32 result[n];
+					oxyF64 reference[n];
+					std::memcpy(result, &out[i], sizeof result);
+					std::memcpy(reference, &exact[i], sizeof reference);
+					oxyF64 scale{};
+					oxyF64 error{};
+					for (oxySize c = 0; c < n; c++)
+					{
+						scale = std::max(scale, std::fabs(reference[c]));
+						error = std::max(error,
+										 std::fabs(result[c] - reference[c]));
+					}
+					if (scale > 0.0)
+						maxError = std::max(maxError, error / scale);
+				}
+				return maxError;
+			}
+
+			struct Suite
+			{
+				const BenchmarkSettings& m_settings;
+				std::vector<BenchmarkResult> m_results{};
+
+				/**
+				 * @brief Best time of passes passes over count inputs, per
+				 * input.
+				 */
+				template <typename Pass>
+				auto Time(Pass pass, oxySize passes, oxySize count) const
+					-> oxyF64
+				{
+					using Clock = std::chrono::steady_clock;
+					auto best = std::numeric_limits<oxyF64>::max();
+					for (oxySize run = 0; run < m_settings.m_runs; run++)
+					{
+						const auto start = Clock::now();
+						for (oxySize p = 0; p < passes; p++)
+						{
+							pass();
+							// Keeps the compiler from merging the passes
+							std::atomic_signal_fence(std::memory_order_seq_cst);
+						}
+						const std::chrono::duration<oxyF64, std::nano>
+							elapsed = Clock::now() - start;
+						best = std::min(best, elapsed.count());
+					}
+					return best / static_cast<oxyF64>(passes * count);
+				}
+				/**
+				 * @brief Best time of one pass over all inputs, per input.
+				 */
+				template <typename Pass> auto Time(Pass pass) const -> oxyF64
+				{
+					return Time(pass, m_settings.m_passes, m_settings.m_count);
+				}
+
+				template <typename Op> auto Compute(Op op) const
+				{
+					std::vector<decltype(op(oxySize{}))> out(
+						m_settings.m_count);
+					for (oxySize i = 0; i < out.size(); i++)
+						out[i] = op(i);
+					return out;
+				}
+
+				/**
+				 * @brief Times out[i] = op(i) and compares the results.
+				 */
+				template <typename Exact, typename Op>
+				auto Add(std::string_view name, std::string_view backend,
+						 const std::vector<Exact>& exact, Op op) -> void
+				{
+					std::vector<decltype(op(oxySize{}))> out(
+						m_settings.m_count);
+					const auto ns = Time([&] {
+						for (oxySize i = 0; i < out.size(); i++)
+							out[i] = op(i);
+					});
+					m_results.push_back({name, std::string{backend}, ns,
+										 MaxRelativeError(out, exact)});
+				}
+				/**
+				 * @brief Times a batch call, then compares out.
+				 */
+				template <typename Out, typename Exact, typename Pass>
+				auto AddBatch(std::string_view name,
+							  const std::vector<Exact>& exact,
+							  const std::vector<Out>& out, Pass pass) -> void
+				{
+					const auto ns = Time(pass);
+					std::string backend{"batch-"};
+					backend += GetBatchBackendName();
+					m_results.push_back(
+						{name, std::move(backend), ns,
+						 MaxRelativeError(out, exact)});
+				}
+			};
+
+			/**
+			 * @brief Structure of arrays copy of points for the batch
+			 * kernels.
+			 */
+			struct PointStreams
+			{
+				std::vector<oxyF32> m_x, m_y, m_z;
+
+				explicit PointStreams(oxySize count)
+					: m_x(count), m_y(count), m_z(count)
+				{
+				}
+				auto Read() const -> Vec3Streams<const oxyF32>
+				{
+					return {m_x.data(), m_y.data(), m_z.data()};
+				}
+				auto Write() -> Vec3Streams<oxyF32>
+				{
+					return {m_x.data(), m_y.data(), m_z.data()};
+				}
+				auto ToAoS(std::vector<oxyVec3>& out) const -> void
+				{
+					for (oxySize i = 0; i < out.size(); i++)
+						out[i] = {m_x[i], m_y[i], m_z[i]};
+				}
+			};
+
+			/**
+			 * @brief Structure of arrays copy of rotations for the batch
+			 * kernels.
+			 */
+			struct RotationStreams
+			{
+				std::vector<oxyF32> m_x, m_y, m_z, m_w;
+
+				explicit RotationStreams(oxySize count)
+					: m_x(count), m_y(count), m_z(count), m_w(count)
+				{
+				}
+				explicit RotationStreams(const std::vector<oxyQuat>& in)
+					: RotationStreams(in.size())
+				{
+					for (oxySize i = 0; i < in.size(); i++)
+					{
+						m_x[i] = in[i].x;
+						m_y[i] = in[i].y;
+						m_z[i] = in[i].z;
+						m_w[i] = in[i].w;
+					}
+				}
+				auto Read() const -> QuatStreams<const oxyF32>
+				{
+					return {m_x.data(), m_y.data(), m_z.data(), m_w.data()};
+				}
+				auto Write() -> QuatStreams<oxyF32>
+				{
+					return {m_x.data(), m_y.data(), m_z.data(), m_w.data()};
+				}
+				auto ToAoS(std::vector<oxyQuat>& out) const -> void
+				{
+					for (oxySize i = 0; i < out.size(); i++)
+						out[i] = {m_x[i], m_y[i], m_z[i], m_w[i]};
+				}
+			};
+
+			/**
+			 * @brief Times oxyFrustum::Intersects over every volume against
+			 * the batch kernel, and counts the volumes the kernel classifies
+			 * differently as its error.
+			 */
+			template <typename Volume, typename Batch>
+			auto AddCull(Suite& suite, std::string_view name,
+						 const oxyFrustum& frustum,
+						 const std::vector<Volume>& volumes, Batch batch)
+				-> void
+			{
+				const auto count = volumes.size();
+				// About as many tests per run as the other rows
+				const auto passes = std::max<oxySize>(
+					1, suite.m_settings.m_count * suite.m_settings.m_passes /
+						   count);
+				std::vector<oxyU32> visible(count);
+				oxySize written{};
+				const auto ns = suite.Time(
+					[&] {
+						written = 0;
+						for (oxySize i = 0; i < count; i++)
+						{
+							if (frustum.Intersects(volumes[i]))
+								visible[written++] = static_cast<oxyU32>(i);
+						}
+					},
+					passes, count);
+				suite.m_results.push_back(
+					{name, std::string{Simd::k_backendName}, ns, 0.0});
+				std::vector<oxyU8> expected(count);
+				for (oxySize i = 0; i < written; i++)
+					expected[visible[i]] = 1;
+
+				const auto batchNs = suite.Time(
+					[&] { written = batch(visible.data()); }, passes, count);
+				std::vector<oxyU8> actual(count);
+				for (oxySize i = 0; i < written; i++)
+					actual[visible[i]] = 1;
+				oxySize mismatches{};
+				for (oxySize i = 0; i < count; i++)
+					mismatches += actual[i] != expected[i];
+				std::string backend{"batch-"};
+				backend += GetBatchBackendName();
+				suite.m_results.push_back({name, std::move(backend), batchNs,
+										   static_cast<oxyF64>(mismatches)});
+			}
+
+			/**
+			 * @brief Times hashing every key, for std::hash against Hasher.
+			 */
+			template <typename Key, typename Hash>
+			auto AddHash(Suite& suite, std::string_view name,
+						 std::string_view backend,
+						 const std::vector<Key>& keys, Hash hash) -> void
+			{
+				std::vector<size_t> out(keys.size());
+				const auto ns = suite.Time([&] {
+					for (oxySize i = 0; i < keys.size(); i++)
+						out[i] = hash(keys[i]);
+				});
+				suite.m_results.push_back(
+					{name, std::string{backend}, ns, 0.0});
+			}
+			/**
+			 * @brief Times looking up every key of a map holding all of them,
+			 * in shuffled order, which also pays for how well the hash
+			 * spreads the keys. Reports the share of failed lookups as the
+			 * error.
+			 */
+			template <typename Map>
+			auto AddFind(Suite& suite, std::string_view name,
+						 std::string_view backend,
+						 const std::vector<typename Map::key_type>& keys)
+				-> void
+			{
+				Map map{};
+				std::vector<oxySize> order(keys.size());
+				for (oxySize i = 0; i < keys.size(); i++)
+				{
+					map.emplace(keys[i], i);
+					order[i] = i;
+				}
+				std::shuffle(order.begin(), order.end(),
+							 std::mt19937{suite.m_settings.m_seed});
+				oxySize misses{};
+				const auto ns = suite.Time([&] {
+					misses = 0;
+					for (const auto i : order)
+					{
+						const auto it = map.find(keys[i]);
+						misses += it == map.end() || it->second != i;
+					}
+				});
+				suite.m_results.push_back(
+					{name, std::string{backend}, ns,
+					 static_cast<oxyF64>(misses) /
+						 static_cast<oxyF64>(keys.size())});
+			}
+
+			/**
+			 * @brief Accumulates the bits of float results into a CRC64.
+			 */
+			struct DeterminismHasher
+			{
+				oxyU64 m_crc{};
+
+				auto Add(oxyF32 value) -> void
+				{
+					// Sign and payload of a NaN differ between CPUs
+					if (value != value)
+						value = std::numeric_limits<oxyF32>::quiet_NaN();
+					oxyU8 bytes[sizeof value];
+					std::memcpy(bytes, &value, sizeof value);
+					m_crc = CRC64Update(m_crc, bytes, sizeof bytes);
+				}
+				/**
+				 * @brief Any type made of floats, e.g. oxyVec3 or oxyMat4x4.
+				 */
+				template <typename T> auto Add(const T& value) -> void
+				{
+					static_assert(sizeof(T) % sizeof(oxyF32) == 0);
+					oxyF32 floats[sizeof(T) / sizeof(oxyF32)];
+					std::memcpy(floats, &value, sizeof floats);
+					for (const auto f : floats)
+						Add(f);
+				}
+			};
+
+			/**
+			 * @brief Uniform in [-scale, scale) from 24 bits of the raw
+			 * mt19937 output, which the standard fixes unlike the
+			 * distributions. Exact in float for power of two scales.
+			 */
+			auto DeterministicRandom(std::mt19937& rng, oxyF32 scale) -> oxyF32
+			{
+				const auto k = static_cast<oxyS32>(rng() >> 8) - (1 << 23);
+				return static_cast<oxyF32>(k) * (scale / (1 << 23));
+			}
+
+			/**
+			 * @brief Rows whose allowed error is not the default, matched by
+			 * name prefix.
+			 */
+			struct RowTolerance
+			{
+				std::string_view m_prefix;
+				oxyF64 m_tolerance;
+			};
+			constexpr RowTolerance k_rowTolerances[]{
+				// Same CRC, same visible set, every key found
+				{"crc64.", 0.0},
+				{"cull.", 0.0},
+				{"map_find.", 0.0},
+				{"hash.", 0.0},
+				// Math::SlerpFast is documented within 4e-5 of Slerp
+				{"quat.slerp_fast", 4e-5},
+				// Accuracy::Fast, a Newton step on the estimate, a few ulp
+				{"vec3.normalize_fast",
+				 4.0 * std::numeric_limits<oxyF32>::epsilon()},
+			};
+			// Room for a different operation order than the plain loop
+			constexpr oxyF64 k_defaultTolerance{1e-5};
+			constexpr oxyF64 k_referenceErrorFactor{8.0};
+
+			/**
+			 * @brief Fills m_tolerance. Dot and cross products of random
+			 * vectors cancel, their error relative to the result is then
+			 * bounded by the same cancellation in the reference row.
+			 */
+			auto SetTolerances(std::vector<BenchmarkResult>& results) -> void
+			{
+				for (auto& result : results)
+				{
+					if (result.m_backend == "reference")
+					{
+						result.m_tolerance =
+							std::numeric_limits<oxyF64>::infinity();
+						continue;
+					}
+					result.m_tolerance = k_defaultTolerance;
+					for (const auto& row : k_rowTolerances)
+					{
+						if (result.m_name.starts_with(row.m_prefix))
+							result.m_tolerance = row.m_tolerance;
+					}
+					for (const auto& reference : results)
+					{
+						if (reference.m_name == result.m_name &&
+							reference.m_backend == "reference")
+						{
+							result.m_tolerance = std::max(
+								result.m_tolerance,
+								k_referenceErrorFactor *
+									reference.m_maxRelativeError);
+						}
+					}
+				}
+			}
+		}; // namespace
+
+		auto RunBenchmarks(const BenchmarkSettings& settings)
+			-> std::vector<BenchmarkResult>
+		{
+			const auto n = settings.m_count;
+			const auto lib = Simd::k_backendName;
+			std::mt19937 rng{settings.m_seed};
+			const auto random = [&](oxyF32 low, oxyF32 high) {
+				return std::uniform_real_distribution<oxyF32>{low, high}(rng);
+			};
+
+			std::vector<oxyVec3> a3(n), b3(n), euler(n);
+			std::vector<oxyVec4> a4(n), b4(n);
+			std::vector<oxyMat4x4> am(n), bm(n);
+			std::vector<oxyQuat> aq(n), bq(n);
+			std::vector<PerspectiveInput> projections(n);
+			for (oxySize i = 0; i < n; i++)
+			{
+				a3[i] = {random(-10, 10), random(-10, 10), random(-10, 10)};
+				b3[i] = {random(-10, 10), random(-10, 10), random(-10, 10)};
+				// y stays clear of +-90 degrees, where Euler angles degenerate
+				euler[i] = {random(-3, 3), random(-1.4f, 1.4f), random(-3, 3)};
+				a4[i] = {random(-10, 10), random(-10, 10), random(-10, 10),
+						 random(-10, 10)};
+				b4[i] = {random(-10, 10), random(-10, 10), random(-10, 10),
+						 random(-10, 10)};
+				for (auto* m : {&am[i], &bm[i]})
+				{
+					for (auto& row : m->m)
+					{
+						for (auto& value : row)
+							value = random(-2, 2);
+					}
+				}
+				aq[i] = oxyQuat{random(-1, 1), random(-1, 1), random(-1, 1),
+								random(-1, 1)}
+							.SafeNormalized();
+				bq[i] = oxyQuat{random(-1, 1), random(-1, 1), random(-1, 1),
+								random(-1, 1)}
+							.SafeNormalized();
+				projections[i] = {random(0.5f, 2.0f), random(1.0f, 2.5f),
+								  random(0.01f, 1.0f), random(10.0f, 1000.0f)};
+			}
+
+			Suite suite{settings};
+			using F = oxyF32;
+			using D = oxyF64;
+
+			// Vectors
+			{
+				const auto exact = suite.Compute([&](oxySize i) {
+					return Add(ToRef<D>(a3[i]), ToRef<D>(b3[i]));
+				});
+				suite.Add("vec3.add", "reference", exact, [&](oxySize i) {
+					return Add(ToRef<F>(a3[i]), ToRef<F>(b3[i]));
+				});
+				suite.Add("vec3.add", lib, exact,
+						  [&](oxySize i) { return a3[i] + b3[i]; });
+			}
+			{
+				const auto exact = suite.Compute([&](oxySize i) {
+					return Dot(ToRef<D>(a3[i]), ToRef<D>(b3[i]));
+				});
+				suite.Add("vec3.dot", "reference", exact, [&](oxySize i) {
+					return Dot(ToRef<F>(a3[i]), ToRef<F>(b3[i]));
+				});
+				suite.Add("vec3.dot", lib, exact, [&](oxySize i) {
+					return a3[i].DotProduct(b3[i]);
+				});
+			}
+			{
+				const auto exact = suite.Compute([&](oxySize i) {
+					return Cross(ToRef<D>(a3[i]), ToRef<D>(b3[i]));
+				});
+				suite.Add("vec3.cross", "reference", exact, [&](oxySize i) {
+					return Cross(ToRef<F>(a3[i]), ToRef<F>(b3[i]));
+				});
+				suite.Add("vec3.cross", lib, exact, [&](oxySize i) {
+					return a3[i].CrossProduct(b3[i]);
+				});
+			}
+			{
+				const auto exact = suite.Compute(
+					[&](oxySize i) { return Normalize(ToRef<D>(a3[i])); });
+				suite.Add("vec3.normalize", "reference", exact,
+						  [&](oxySize i) {
+							  return Normalize(ToRef<F>(a3[i]));
+						  });
+				suite.Add("vec3.normalize", lib, exact, [&](oxySize i) {
+					return a3[i].Normalized<Accuracy::Exact>();
+				});
+				suite.Add("vec3.normalize_fast", lib, exact, [&](oxySize i) {
+					return a3[i].Normalized<Accuracy::Fast>();
+				});
+
+				const PointStreams in = [&] {
+					PointStreams streams{n};
+					for (oxySize i = 0; i < n; i++)
+					{
+						streams.m_x[i] = a3[i].x;
+						streams.m_y[i] = a3[i].y;
+						streams.m_z[i] = a3[i].z;
+					}
+					return streams;
+				}();
+				PointStreams out{n};
+				std::vector<oxyVec3> result(n);
+				for (const auto accuracy : {Accuracy::Exact, Accuracy::Fast})
+				{
+					NormalizeBatch(in.Read(), out.Write(), n, accuracy);
+					out.ToAoS(result);
+					suite.AddBatch(accuracy == Accuracy::Fast
+									   ? "vec3.normalize_fast"
+									   : "vec3.normalize",
+								   exact, result, [&] {
+									   NormalizeBatch(in.Read(), out.Write(),
+													  n, accuracy);
+								   });
+				}
+			}
+			{
+				const auto exact = suite.Compute([&](oxySize i) {
+					return Dot(ToRef<D>(a4[i]), ToRef<D>(b4[i]));
+				});
+				suite.Add("vec4.dot", "reference", exact, [&](oxySize i) {
+					return Dot(ToRef<F>(a4[i]), ToRef<F>(b4[i]));
+				});
+				suite.Add("vec4.dot", lib, exact, [&](oxySize i) {
+					return a4[i].DotProduct(b4[i]);
+				});
+			}
+			{
+				const auto exact = suite.Compute([&](oxySize i) {
+					return Mul(ToRef<D>(a4[i]), ToRef<D>(b4[i]));
+				});
+				suite.Add("vec4.mul", "reference", exact, [&](oxySize i) {
+					return Mul(ToRef<F>(a4[i]), ToRef<F>(b4[i]));
+				});
+				suite.Add("vec4.mul", lib, exact,
+						  [&](oxySize i) { return a4[i] * b4[i]; });
+			}
+
+			// Matrices
+			{
+				const auto exact = suite.Compute([&](oxySize i) {
+					return Multiply(ToRef<D>(am[i]), ToRef<D>(bm[i]));
+				});
+				suite.Add("mat4.multiply", "reference", exact, [&](oxySize i) {
+					return Multiply(ToRef<F>(am[i]), ToRef<F>(bm[i]));
+				});
+				suite.Add("mat4.multiply", lib, exact,
+						  [&](oxySize i) { return am[i] * bm[i]; });
+				std::vector<oxyMat4x4> out(n);
+				MultiplyBatch(am.data(), bm.data(), out.data(), n);
+				suite.AddBatch("mat4.multiply", exact, out, [&] {
+					MultiplyBatch(am.data(), bm.data(), out.data(), n);
+				});
+			}
+			{
+				const auto exact = suite.Compute([&](oxySize i) {
+					return Transform(ToRef<D>(am[i]), ToRef<D>(a4[i]));
+				});
+				suite.Add("mat4.transform", "reference", exact,
+						  [&](oxySize i) {
+							  return Transform(ToRef<F>(am[i]),
+											   ToRef<F>(a4[i]));
+						  });
+				suite.Add("mat4.transform", lib, exact,
+						  [&](oxySize i) { return am[i] * a4[i]; });
+			}
+			{
+				// The batch kernel takes one matrix for all points
+				const auto& m = am[0];
+				const auto exactMatrix = ToRef<D>(m);
+				const auto floatMatrix = ToRef<F>(m);
+				const auto exact = suite.Compute([&](oxySize i) {
+					return TransformPoint(exactMatrix, ToRef<D>(a3[i]));
+				});
+				suite.Add("mat4.transform_point", "reference", exact,
+						  [&](oxySize i) {
+							  return TransformPoint(floatMatrix,
+													ToRef<F>(a3[i]));
+						  });
+				suite.Add("mat4.transform_point", lib, exact, [&](oxySize i) {
+					const auto r = m * oxyVec4{a3[i].x, a3[i].y, a3[i].z, 1};
+					return oxyVec3{r.x, r.y, r.z};
+				});
+				PointStreams in{n};
+				for (oxySize i = 0; i < n; i++)
+				{
+					in.m_x[i] = a3[i].x;
+					in.m_y[i] = a3[i].y;
+					in.m_z[i] = a3[i].z;
+				}
+				PointStreams out{n};
+				std::vector<oxyVec3> result(n);
+				TransformPointsBatch(m, in.Read(), out.Write(), n);
+				out.ToAoS(result);
+				suite.AddBatch("mat4.transform_point", exact, result, [&] {
+					TransformPointsBatch(m, in.Read(), out.Write(), n);
+				});
+			}
+
+			{
+				// Diagonally dominant, so every matrix is well conditioned and
+				// the error measures the kernel rather than the input
+				std::vector<oxyMat4x4> general(n);
+				for (oxySize i = 0; i < n; i++)
+				{
+					general[i] = am[i];
+					for (int j = 0; j < 4; j++)
+						general[i].m[j][j] += am[i].m[j][j] < 0 ? -6 : 6;
+				}
+				const auto exact = suite.Compute(
+					[&](oxySize i) { return Inverse(ToRef<D>(general[i])); });
+				suite.Add("mat4.inverse", "reference", exact, [&](oxySize i) {
+					return Inverse(ToRef<F>(general[i]));
+				});
+				suite.Add("mat4.inverse", lib, exact,
+						  [&](oxySize i) { return general[i].Inversed(); });
+				std::vector<oxyMat4x4> out(n);
+				InverseBatch(general.data(), out.data(), n);
+				suite.AddBatch("mat4.inverse", exact, out, [&] {
+					InverseBatch(general.data(), out.data(), n);
+				});
+			}
+			{
+				// Translate, rotate and non-uniform scale, as in scene graphs
+				std::vector<oxyMat4x4> affine(n);
+				for (oxySize i = 0; i < n; i++)
+				{
+					const oxyVec3 scale{random(0.25f, 4), random(0.25f, 4),
+										random(0.25f, 4)};
+					affine[i] = Translate(
+						Rotate(Scale(oxyMat4x4::Identity(), scale), aq[i]),
+						a3[i]);
+				}
+				const auto inverses = suite.Compute(
+					[&](oxySize i) { return Inverse(ToRef<D>(affine[i])); });
+				suite.Add("mat4.inverse_affine", "reference", inverses,
+						  [&](oxySize i) {
+							  return InverseAffine(ToRef<F>(affine[i]));
+						  });
+				suite.Add("mat4.inverse_affine", lib, inverses,
+						  [&](oxySize i) { return InverseAffine(affine[i]); });
+				std::vector<oxyMat4x4> out(n);
+				InverseAffineBatch(affine.data(), out.data(), n);
+				suite.AddBatch("mat4.inverse_affine", inverses, out, [&] {
+					InverseAffineBatch(affine.data(), out.data(), n);
+				});
+
+				const auto exact = suite.Compute([&](oxySize i) {
+					return TransposeUpper3x3(inverses[i]);
+				});
+				suite.Add("mat4.inverse_transpose", "reference", exact,
+						  [&](oxySize i) {
+							  return InverseTranspose(ToRef<F>(affine[i]));
+						  });
+				suite.Add("mat4.inverse_transpose", lib, exact,
+						  [&](oxySize i) {
+							  return InverseTranspose(affine[i]);
+						  });
+				InverseTransposeBatch(affine.data(), out.data(), n);
+				suite.AddBatch("mat4.inverse_transpose", exact, out, [&] {
+					InverseTransposeBatch(affine.data(), out.data(), n);
+				});
+			}
+
+			// Camera
+			{
+				const RefVec3<D> exactUp{0, 1, 0};
+				const RefVec3<F> floatUp{0, 1, 0};
+				const auto exact = suite.Compute([&](oxySize i) {
+					return LookAt(ToRef<D>(a3[i]), ToRef<D>(b3[i]), exactUp);
+				});
+				suite.Add("camera.look_at", "reference", exact,
+						  [&](oxySize i) {
+							  return LookAt(ToRef<F>(a3[i]), ToRef<F>(b3[i]),
+											floatUp);
+						  });
+				suite.Add("camera.look_at", lib, exact, [&](oxySize i) {
+					return Math::LookAt(a3[i], b3[i], {0, 1, 0});
+				});
+			}
+			{
+				const auto exact = suite.Compute([&](oxySize i) {
+					const auto& p = projections[i];
+					return Perspective<D>(p.m_fovy, p.m_aspect, p.m_near,
+										  p.m_far);
+				});
+				suite.Add("camera.perspective", "reference", exact,
+						  [&](oxySize i) {
+							  const auto& p = projections[i];
+							  return Perspective<F>(p.m_fovy, p.m_aspect,
+													p.m_near, p.m_far);
+						  });
+				suite.Add("camera.perspective", lib, exact, [&](oxySize i) {
+					const auto& p = projections[i];
+					return Math::Perspective(p.m_fovy, p.m_aspect, p.m_near,
+											 p.m_far);
+				});
+			}
+
+			// Quaternions
+			{
+				const auto exact = suite.Compute([&](oxySize i) {
+					return QuatRotate(ToRef<D>(aq[i]), ToRef<D>(a3[i]));
+				});
+				suite.Add("quat.rotate", "reference", exact, [&](oxySize i) {
+					return QuatRotate(ToRef<F>(aq[i]), ToRef<F>(a3[i]));
+				});
+				suite.Add("quat.rotate", lib, exact,
+						  [&](oxySize i) { return aq[i] * a3[i]; });
+			}
+			{
+				const auto exact = suite.Compute([&](oxySize i) {
+					return QuatMultiply(ToRef<D>(aq[i]), ToRef<D>(bq[i]));
+				});
+				suite.Add("quat.multiply", "reference", exact, [&](oxySize i) {
+					return QuatMultiply(ToRef<F>(aq[i]), ToRef<F>(bq[i]));
+				});
+				suite.Add("quat.multiply", lib, exact,
+						  [&](oxySize i) { return aq[i] * bq[i]; });
+			}
+			{
+				const auto exact = suite.Compute(
+					[&](oxySize i) { return EulerToQuat(ToRef<D>(euler[i])); });
+				suite.Add("quat.from_euler", "reference", exact,
+						  [&](oxySize i) {
+							  return EulerToQuat(ToRef<F>(euler[i]));
+						  });
+				suite.Add("quat.from_euler", lib, exact, [&](oxySize i) {
+					return EulerAnglesToQuat(euler[i]);
+				});
+
+				// Rotations with a known, well conditioned decomposition
+				std::vector<oxyQuat> rotations(n);
+				for (oxySize i = 0; i < n; i++)
+				{
+					const auto q = exact[i];
+					rotations[i] = {static_cast<F>(q.x), static_cast<F>(q.y),
+									static_cast<F>(q.z), static_cast<F>(q.w)};
+				}
+				const auto exactEuler = suite.Compute([&](oxySize i) {
+					return QuatToEuler(ToRef<D>(rotations[i]));
+				});
+				suite.Add("quat.to_euler", "reference", exactEuler,
+						  [&](oxySize i) {
+							  return QuatToEuler(ToRef<F>(rotations[i]));
+						  });
+				suite.Add("quat.to_euler", lib, exactEuler, [&](oxySize i) {
+					return QuatToEulerAngles(rotations[i]);
+				});
+			}
+			{
+				std::vector<oxyF32> t(n);
+				for (auto& value : t)
+					value = random(0, 1);
+				// Both the constant angular velocity blends and Nlerp, whose
+				// error is its distance from it
+				const auto exact = suite.Compute([&](oxySize i) {
+					return QuatSlerp(ToRef<D>(aq[i]), ToRef<D>(bq[i]),
+									 static_cast<D>(t[i]));
+				});
+				suite.Add("quat.nlerp", "reference", exact, [&](oxySize i) {
+					return QuatNlerp(ToRef<F>(aq[i]), ToRef<F>(bq[i]), t[i]);
+				});
+				suite.Add("quat.nlerp", lib, exact, [&](oxySize i) {
+					return Nlerp(aq[i], bq[i], t[i]);
+				});
+				suite.Add("quat.slerp", "reference", exact, [&](oxySize i) {
+					return QuatSlerp(ToRef<F>(aq[i]), ToRef<F>(bq[i]), t[i]);
+				});
+				suite.Add("quat.slerp", lib, exact, [&](oxySize i) {
+					return Slerp(aq[i], bq[i], t[i]);
+				});
+				suite.Add("quat.slerp_fast", lib, exact, [&](oxySize i) {
+					return SlerpFast(aq[i], bq[i], t[i]);
+				});
+
+				const RotationStreams a{aq};
+				const RotationStreams b{bq};
+				RotationStreams out{n};
+				const QuatBlendStreams blend{a.Read(), b.Read(), t.data(),
+											 out.Write()};
+				std::vector<oxyQuat> result(n);
+				using Kernel = void (*)(const QuatBlendStreams&, oxySize);
+				const std::pair<std::string_view, Kernel> kernels[]{
+					{"quat.nlerp", &NlerpBatch},
+					{"quat.slerp", &SlerpBatch},
+					{"quat.slerp_fast", &SlerpFastBatch},
+				};
+				for (const auto& [name, kernel] : kernels)
+				{
+					kernel(blend, n);
+					out.ToAoS(result);
+					suite.AddBatch(name, exact, result,
+								   [&] { kernel(blend, n); });
+				}
+			}
+			// Culling, at the scene sizes where the batch kernels start to
+			// matter
+			{
+				const auto view = Math::LookAt({0, 0, 0}, {0, 0, 1}, {0, 1, 0});
+				const auto projection =
+					Math::Perspective(1.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+				const auto frustum =
+					oxyFrustum::FromViewProjection(view * projection);
+				struct CullSize
+				{
+					std::string_view m_sphere, m_aabb;
+					oxySize m_count;
+				};
+				static constexpr CullSize k_sizes[]{
+					{"cull.sphere.10k", "cull.aabb.10k", 10000},
+					{"cull.sphere.100k", "cull.aabb.100k", 100000},
+					{"cull.sphere.1m", "cull.aabb.1m", 1000000},
+				};
+				for (const auto& size : k_sizes)
+				{
+					// Scattered around the camera, about a tenth is visible
+					const auto count = size.m_count;
+					std::vector<oxySphere> spheres(count);
+					std::vector<oxyAABB> boxes(count);
+					PointStreams centers{count};
+					PointStreams extents{count};
+					std::vector<oxyF32> radii(count);
+					for (oxySize i = 0; i < count; i++)
+					{
+						const oxyVec3 center{random(-500, 500),
+											 random(-500, 500),
+											 random(-500, 500)};
+						const oxyVec3 extent{random(0.1f, 10), random(0.1f, 10),
+											 random(0.1f, 10)};
+						spheres[i] = {center, extent.Magnitude()};
+						boxes[i] = {center, extent};
+						centers.m_x[i] = center.x;
+						centers.m_y[i] = center.y;
+						centers.m_z[i] = center.z;
+						extents.m_x[i] = extent.x;
+						extents.m_y[i] = extent.y;
+						extents.m_z[i] = extent.z;
+						radii[i] = spheres[i].radius;
+					}
+					const SphereStreams sphereStreams{centers.Read(),
+													  radii.data()};
+					AddCull(suite, size.m_sphere, frustum, spheres,
+							[&](oxyU32* visible) {
+								return CullSpheresBatch(frustum, sphereStreams,
+														visible, count);
+							});
+					const AABBStreams boxStreams{centers.Read(),
+												 extents.Read()};
+					AddCull(suite, size.m_aabb, frustum, boxes,
+							[&](oxyU32* visible) {
+								return CullAABBsBatch(frustum, boxStreams,
+													  visible, count);
+							});
+				}
+			}
+			// Hashing, timed per byte
+			{
+				std::vector<oxyU8> bytes(n * 16);
+				for (auto& byte : bytes)
+					byte = static_cast<oxyU8>(rng());
+				const auto exact = CRC64Eval(bytes.data(), bytes.size());
+				for (oxyU8 i = 0; i < CRC64Impl_Count; i++)
+				{
+					const auto impl = static_cast<CRC64Impl>(i);
+					if (!IsCRC64ImplSupported(impl))
+						continue;
+					oxyU64 crc{};
+					const auto ns = suite.Time([&] {
+						crc = CRC64UpdateWith(impl, 0, bytes.data(),
+											  bytes.size());
+					});
+					suite.m_results.push_back(
+						{"crc64.byte", std::string{GetCRC64ImplName(impl)},
+						 ns / 16.0, crc == exact ? 0.0 : 1.0});
+				}
+			}
+			// Hash table keys: sequential object ids, pointers to objects
+			// allocated side by side, short names and asset paths
+			{
+				struct Slot
+				{
+					oxyU64 m_data[6];
+				};
+				std::vector<Slot> slots(n);
+				std::vector<oxyU64> ids(n);
+				std::vector<const Slot*> pointers(n);
+				std::vector<std::string> names(n), paths(n);
+				char text[64]{};
+				for (oxySize i = 0; i < n; i++)
+				{
+					ids[i] = 0x40000001 + i;
+					pointers[i] = &slots[i];
+					std::snprintf(text, sizeof text, "Actor%zu", i);
+					names[i] = text;
+					std::snprintf(text, sizeof text,
+								  "Textures/Props/crate_%04zu_albedo.dds", i);
+					paths[i] = text;
+				}
+				const auto addKeys = [&](std::string_view hashName,
+										 std::string_view findName,
+										 const auto& keys) {
+					using Key = std::decay_t<decltype(keys[0])>;
+					AddHash(suite, hashName, "std", keys, std::hash<Key>{});
+					AddHash(suite, hashName, "oxygen", keys, Hasher{});
+					AddFind<std::unordered_map<Key, oxySize>>(suite, findName,
+															  "std", keys);
+					AddFind<std::unordered_map<Key, oxySize, Hasher>>(
+						suite, findName, "oxygen", keys);
+				};
+				addKeys("hash.id", "map_find.id", ids);
+				addKeys("hash.pointer", "map_find.pointer", pointers);
+				addKeys("hash.name", "map_find.name", names);
+				addKeys("hash.path", "map_find.path", paths);
+			}
+			SetTolerances(suite.m_results);
+			return std::move(suite.m_results);
+		}
+
+		auto DumpBenchmarkCSV(std::span<const BenchmarkResult> results)
+			-> std::string
+		{
+			std::string out{
+				"name,backend,ns_per_op,max_rel_error,tolerance,passed\n"};
+			char line[256]{};
+			for (const auto& result : results)
+			{
+				std::snprintf(line, sizeof line,
+							  "%.*s,%s,%.4f,%.3e,%.3e,%d\n",
+							  static_cast<int>(result.m_name.size()),
+							  result.m_name.data(), result.m_backend.c_str(),
+							  result.m_nsPerOp, result.m_maxRelativeError,
+							  result.m_tolerance,
+							  result.IsWithinTolerance() ? 1 : 0);
+				out += line;
+			}
+			return out;
+		}
+
+		auto RunDeterminismHash(oxyU32 seed) -> DeterminismHash
+		{
+			constexpr oxySize k_count{1 << 16};
+			std::mt19937 rng{seed};
+			const auto random = [&](oxyF32 scale) {
+				return DeterministicRandom(rng, scale);
+			};
+			DeterminismHash result{};
+
+			DeterminismHasher trig{};
+			for (oxySize i = 0; i < k_count; i++)
+			{
+				const auto x = random(128);
+				trig.Add(Sin(x));
+				trig.Add(Cos(x));
+				trig.Add(Tan(x));
+				trig.Add(Sqrt(std::fabs(x)));
+			}
+			result.m_trig = trig.m_crc;
+
+			DeterminismHasher inverseTrig{};
+			for (oxySize i = 0; i < k_count; i++)
+			{
+				const auto x = random(1);
+				inverseTrig.Add(Asin(x));
+				inverseTrig.Add(Acos(x));
+				const auto y = random(128);
+				inverseTrig.Add(Atan2(y, random(128)));
+			}
+			result.m_inverseTrig = inverseTrig.m_crc;
+
+			// Fewer inputs, each goes through many operations
+			constexpr oxySize k_compositeCount{k_count / 16};
+			const auto randomVec3 = [&](oxyF32 scale) {
+				const auto x = random(scale);
+				const auto y = random(scale);
+				return oxyVec3{x, y, random(scale)};
+			};
+			const auto randomQuat = [&] {
+				const auto x = random(1);
+				const auto y = random(1);
+				const auto z = random(1);
+				return oxyQuat{x, y, z, random(1)}.SafeNormalized();
+			};
+			std::vector<oxyQuat> aq(k_compositeCount), bq(k_compositeCount);
+			std::vector<oxyF32> t(k_compositeCount);
+			std::vector<oxyMat4x4> matrices(k_compositeCount);
+			std::vector<oxySphere> spheres(k_compositeCount);
+			for (oxySize i = 0; i < k_compositeCount; i++)
+			{
+				aq[i] = randomQuat();
+				bq[i] = randomQuat();
+				t[i] = random(0.5f) + 0.5f;
+				const auto scale = randomVec3(1) + oxyVec3{2, 2, 2};
+				const auto translation = randomVec3(64);
+				matrices[i] = Translate(
+					Rotate(Scale(oxyMat4x4::Identity(), scale), aq[i]),
+					translation);
+				spheres[i] = {randomVec3(256), random(16) + 16};
+			}
+
+			DeterminismHasher composite{};
+			const auto frustum = oxyFrustum::FromViewProjection(
+				LookAt({0, 0, 0}, {0, 0, 1}, {0, 1, 0}) *
+				Perspective(1.0f, 16.0f / 9.0f, 0.1f, 1000.0f));
+			composite.Add(frustum);
+			for (oxySize i = 0; i < k_compositeCount; i++)
+			{
+				const auto& m = matrices[i];
+				const auto v = randomVec3(64);
+				composite.Add(m * matrices[k_compositeCount - 1 - i]);
+				composite.Add(m * oxyVec4{v.x, v.y, v.z, 1});
+				composite.Add(m.Inversed());
+				composite.Add(InverseAffine(m));
+				composite.Add(InverseTranspose(m));
+				composite.Add(v.Normalized());
+				composite.Add(v.CrossProduct(randomVec3(64)));
+				composite.Add(aq[i] * bq[i]);
+				composite.Add(aq[i] * v);
+				composite.Add(QuatToEulerAngles(aq[i]));
+				composite.Add(EulerAnglesToQuat(v * (1.0f / 32)));
+				composite.Add(Nlerp(aq[i], bq[i], t[i]));
+				composite.Add(Slerp(aq[i], bq[i], t[i]));
+				composite.Add(SlerpFast(aq[i], bq[i], t[i]));
+				composite.Add(LookAt(v, randomVec3(64), {0, 1, 0}));
+				composite.Add(Perspective(t[i] + 0.5f, 16.0f / 9.0f, 0.1f,
+										  1000.0f));
+				composite.Add(spheres[i].Transformed(m));
+				composite.Add(frustum.Intersects(spheres[i]) ? 1.0f : 0.0f);
+			}
+
+			// The batch kernels, which pick their instruction set at run time
+			std::vector<oxyMat4x4> outMatrices(k_compositeCount);
+			MultiplyBatch(matrices.data(), matrices.data(), outMatrices.data(),
+						  k_compositeCount);
+			for (const auto& m : outMatrices)
+				composite.Add(m);
+			InverseBatch(matrices.data(), outMatrices.data(),
+						 k_compositeCount);
+			for (const auto& m : outMatrices)
+				composite.Add(m);
+			PointStreams points{k_compositeCount};
+			std::vector<oxyF32> radii(k_compositeCount);
+			for (oxySize i = 0; i < k_compositeCount; i++)
+			{
+				points.m_x[i] = spheres[i].center.x;
+				points.m_y[i] = spheres[i].center.y;
+				points.m_z[i] = spheres[i].center.z;
+				radii[i] = spheres[i].radius;
+			}
+			std::vector<oxyU32> visible(k_compositeCount);
+			const auto visibleCount =
+				CullSpheresBatch(frustum, {points.Read(), radii.data()},
+								 visible.data(), k_compositeCount);
+			composite.Add(static_cast<oxyF32>(visibleCount));
+			PointStreams transformed{k_compositeCount};
+			TransformPointsBatch(matrices[0], points.Read(),
+								 transformed.Write(), k_compositeCount);
+			NormalizeBatch(transformed.Read(), transformed.Write(),
+						   k_compositeCount);
+			std::vector<oxyVec3> vectors(k_compositeCount);
+			transformed.ToAoS(vectors);
+			for (const auto& v : vectors)
+				composite.Add(v);
+			const RotationStreams a{aq};
+			const RotationStreams b{bq};
+			RotationStreams out{k_compositeCount};
+			std::vector<oxyQuat> rotations(k_compositeCount);
+			for (const auto kernel :
+				 {&NlerpBatch, &SlerpBatch, &SlerpFastBatch})
+			{
+				kernel({a.Read(), b.Read(), t.data(), out.Write()},
+					   k_compositeCount);
+				out.ToAoS(rotations);
+				for (const auto& q : rotations)
+					composite.Add(q);
+			}
+			result.m_composite = composite.m_crc;
+			return result;
+		}
+
+		auto DumpDeterminismHashCSV(const DeterminismHash& hash)
+			-> std::string
+		{
+			char line[128]{};
+			std::snprintf(line, sizeof line,
+						  "trig,inverse_trig,composite\n"
+						  "%016llx,%016llx,%016llx\n",
+						  static_cast<unsigned long long>(hash.m_trig),
+						  static_cast<unsigned long long>(hash.m_inverseTrig),
+						  static_cast<unsigned long long>(hash.m_composite));
+			return line;
+		}
+	}; // namespace Math
+}; // namespace oxygen
@@ -0,0 +1,106 @@
+#pragma once
+
+namespace oxygen
+{
+	namespace Math
+	{
+		/**
+		 * @brief Throughput and accuracy of one operation on one backend.
+		 */
+		struct BenchmarkResult
+		{
+			// Operation, e.g. "mat4.multiply", "cull.sphere.100k" for culling
+			// that many volumes, "crc64.byte" for hashing timed per byte,
+			// "hash.id" or "map_find.id" for hash table keys
+			std::string_view m_name{};
+			// "reference" for the plain float loop the library replaces,
+			// Simd::k_backendName for the math types, "batch-" and
+			// GetBatchBackendName() for the stream kernels, GetCRC64ImplName()
+			// for CRC64, "std" or "oxygen" for std::hash against Hasher
+			std::string m_backend{};
+			oxyF64 m_nsPerOp{};
+			// Largest |result - exact| / max |exact| over the components of
+			// one output, exact being the same operation in double precision.
+			// CRC64 reports 1 if it differs from CRC64Eval, culling the
+			// number of volumes classified unlike oxyFrustum::Intersects, map
+			// lookups the share of keys not found.
+			oxyF64 m_maxRelativeError{};
+			// Largest passing m_maxRelativeError: 0 for the rows that must
+			// be exact, the documented bound of approximations, else 1e-5
+			// or 8 times the reference row's error when inputs cancel.
+			// Infinite for the reference rows themselves.
+			oxyF64 m_tolerance{};
+
+			auto IsWithinTolerance() const -> oxyBool
+			{
+				return m_maxRelativeError <= m_tolerance;
+			}
+		};
+
+		struct BenchmarkSettings
+		{
+			// Inputs per pass, small enough to stay in cache
+			oxySize m_count{4096};
+			oxySize m_passes{64};
+			// Best of this many timed runs is reported
+			oxySize m_runs{5};
+			oxyU32 m_seed{1};
+		};
+
+		/**
+		 * @brief Times and checks the vector, matrix, camera, quaternion and
+		 * culling operations of Math/Defs.h, the batch kernels, the run time
+		 * CRC64 implementations and the hash table hashes. Needs no window
+		 * or engine state.
+		 */
+		auto RunBenchmarks(const BenchmarkSettings& settings = {})
+			-> std::vector<BenchmarkResult>;
+
+		/**
+		 * @brief One CSV row per result, for comparing runs across changes.
+		 */
+		auto DumpBenchmarkCSV(std::span<const BenchmarkResult> results)
+			-> std::string;
+
+		/**
+		 * @brief CRC64 of the output bits of the Math helpers over a corpus
+		 * drawn from a seed. Builds with OXYMATHDETERMINISTIC must agree on
+		 * every compiler and CPU, CI compares them across toolchains.
+		 */
+		struct DeterminismHash
+		{
+			// Math::Sin, Cos, Tan and Sqrt over [-128, 128)
+			oxyU64 m_trig{};
+			// Math::Asin and Acos over [-1, 1), Atan2 over [-128, 128)^2
+			oxyU64 m_inverseTrig{};
+			// Matrix, quaternion, camera and frustum helpers of Math/Defs.h
+			// and the batch kernels
+			oxyU64 m_composite{};
+
+			auto operator==(const DeterminismHash&) const -> bool = default;
+		};
+
+		/**
+		 * @brief RunDeterminismHash() of OXYMATHDETERMINISTIC builds, which
+		 * must not change with the compiler or CPU. Only update it when the
+		 * corpus or Math::Deterministic changes on purpose.
+		 */
+		static inline constexpr DeterminismHash k_deterministicHash{
+			0x5696a458d5b969d9ULL,
+			0x73b1d21061b810a4ULL,
+			0x91f51d0e31ac35b8ULL,
+		};
+
+		/**
+		 * @brief The corpus only uses inputs that are exact in float and
+		 * the raw mt19937 sequence, so it is the same everywhere. NaN
+		 * results are hashed as one canonical NaN.
+		 */
+		auto RunDeterminismHash(oxyU32 seed = 1) -> DeterminismHash;
+		/**
+		 * @brief A CSV header and one row with the three hashes in hex.
+		 */
+		auto DumpDeterminismHashCSV(const DeterminismHash& hash)
+			-> std::string;
+	}; // namespace Math
+}; // namespace oxygen
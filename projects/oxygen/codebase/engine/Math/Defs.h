@@ -1,10 +1,17 @@
 #pragma once
 
+#include "Simd.h"
+#include "Deterministic.h"
+
 struct oxyVec2;
 struct oxyVec3;
 struct oxyVec4;
 struct oxyQuat;
 struct oxyMat4x4;
+struct oxyAABB;
+struct oxySphere;
+struct oxyOBB;
+struct oxyFrustum;
 
 namespace oxygen
 {
@@ -16,117 +23,279 @@ namespace oxygen
 
 		static inline constexpr auto RadToDeg = 180.0f / Pi;
 		static inline constexpr auto DegToRad = Pi / 180.0f;
+
+		namespace ConstexprImpl
+		{
+			/**
+			 * @brief Newton iteration from a guess with the exponent halved.
+			 */
+			constexpr auto Sqrt(oxyF64 x) -> oxyF64
+			{
+				if (x != x || x < 0.0)
+					return std::numeric_limits<oxyF64>::quiet_NaN();
+				if (x == 0.0 || x == std::numeric_limits<oxyF64>::infinity())
+					return x;
+				const auto bits = std::bit_cast<oxyU64>(x);
+				auto r = std::bit_cast<oxyF64>((bits >> 1) +
+											   0x1FF8000000000000ull);
+				for (int i = 0; i < 64; i++)
+				{
+					const auto next = 0.5 * (r + x / r);
+					if (next == r)
+						break;
+					r = next;
+				}
+				return r;
+			}
+
+			/**
+			 * @brief Reduced to [-pi / 2, pi / 2], then a Taylor series.
+			 */
+			constexpr auto Sin(oxyF64 x) -> oxyF64
+			{
+				constexpr auto pi = 3.14159265358979323846;
+				const auto turns = x / (2.0 * pi);
+				const auto whole = static_cast<oxyF64>(
+					static_cast<oxyS64>(turns + (turns < 0.0 ? -0.5 : 0.5)));
+				auto r = x - whole * 2.0 * pi;
+				if (r > 0.5 * pi)
+					r = pi - r;
+				else if (r < -0.5 * pi)
+					r = -pi - r;
+				const auto r2 = r * r;
+				auto term = r;
+				auto sum = r;
+				for (int n = 1; n < 12; n++)
+				{
+					term *= -r2 / ((2.0 * n) * (2.0 * n + 1.0));
+					sum += term;
+				}
+				return sum;
+			}
+			constexpr auto Cos(oxyF64 x) -> oxyF64
+			{
+				return Sin(x + 1.57079632679489661923);
+			}
+		}; // namespace ConstexprImpl
+
+		/**
+		 * @brief Usable in constant expressions, e.g. for tables built at
+		 * compile time. At run time these call the standard library, or
+		 * Math::Deterministic when OXYMATHDETERMINISTIC is defined.
+		 */
+		constexpr auto Sqrt(oxyF32 x) -> oxyF32
+		{
+			if (std::is_constant_evaluated())
+				return static_cast<oxyF32>(ConstexprImpl::Sqrt(x));
+			return std::sqrt(x);
+		}
+		constexpr auto Sin(oxyF32 x) -> oxyF32
+		{
+			if (std::is_constant_evaluated())
+				return static_cast<oxyF32>(ConstexprImpl::Sin(x));
+#ifdef OXYMATHDETERMINISTIC
+			return Deterministic::Sin(x);
+#else
+			return std::sin(x);
+#endif
+		}
+		constexpr auto Cos(oxyF32 x) -> oxyF32
+		{
+			if (std::is_constant_evaluated())
+				return static_cast<oxyF32>(ConstexprImpl::Cos(x));
+#ifdef OXYMATHDETERMINISTIC
+			return Deterministic::Cos(x);
+#else
+			return std::cos(x);
+#endif
+		}
+		constexpr auto Tan(oxyF32 x) -> oxyF32
+		{
+			if (std::is_constant_evaluated())
+			{
+				return static_cast<oxyF32>(ConstexprImpl::Sin(x) /
+										   ConstexprImpl::Cos(x));
+			}
+#ifdef OXYMATHDETERMINISTIC
+			return Deterministic::Tan(x);
+#else
+			return std::tan(x);
+#endif
+		}
+		inline auto Asin(oxyF32 x) -> oxyF32
+		{
+#ifdef OXYMATHDETERMINISTIC
+			return Deterministic::Asin(x);
+#else
+			return std::asin(x);
+#endif
+		}
+		inline auto Acos(oxyF32 x) -> oxyF32
+		{
+#ifdef OXYMATHDETERMINISTIC
+			return Deterministic::Acos(x);
+#else
+			return std::acos(x);
+#endif
+		}
+		inline auto Atan2(oxyF32 y, oxyF32 x) -> oxyF32
+		{
+#ifdef OXYMATHDETERMINISTIC
+			return Deterministic::Atan2(y, x);
+#else
+			return std::atan2(y, x);
+#endif
+		}
+
+		/**
+		 * @brief 1 / sqrt(x) at accuracy A. SafeRSqrt gives zero instead of
+		 * infinity or NaN below k_minLengthSquared, without branching.
+		 */
+		template <Accuracy A = k_defaultAccuracy>
+		constexpr auto RSqrt(oxyF32 x) -> oxyF32
+		{
+			if (std::is_constant_evaluated() || A == Accuracy::Exact)
+				return 1.0f / Sqrt(x);
+			return Simd::GetX(Simd::RSqrt<A>(Simd::Splat(x)));
+		}
+		template <Accuracy A = k_defaultAccuracy>
+		constexpr auto SafeRSqrt(oxyF32 x) -> oxyF32
+		{
+			if (std::is_constant_evaluated())
+				return x >= k_minLengthSquared ? 1.0f / Sqrt(x) : 0.0f;
+			return Simd::GetX(Simd::SafeRSqrt<A>(Simd::Splat(x)));
+		}
 	}; // namespace Math
 };	   // namespace oxygen
 
-inline auto operator-(const oxyVec2& a) -> oxyVec2;
-inline auto operator+(const oxyVec2& a, const oxyVec2& b) -> oxyVec2;
-inline auto operator-(const oxyVec2& a, const oxyVec2& b) -> oxyVec2;
-inline auto operator*(const oxyVec2& a, const oxyVec2& b) -> oxyVec2;
-inline auto operator/(const oxyVec2& a, const oxyVec2& b) -> oxyVec2;
-inline auto operator*(const oxyVec2& a, oxyF32 b) -> oxyVec2;
-inline auto operator/(const oxyVec2& a, oxyF32 b) -> oxyVec2;
-
-inline auto operator-(const oxyVec3& a) -> oxyVec3;
-inline auto operator+(const oxyVec3& a, const oxyVec3& b) -> oxyVec3;
-inline auto operator-(const oxyVec3& a, const oxyVec3& b) -> oxyVec3;
-inline auto operator*(const oxyVec3& a, const oxyVec3& b) -> oxyVec3;
-inline auto operator/(const oxyVec3& a, const oxyVec3& b) -> oxyVec3;
-inline auto operator*(const oxyVec3& a, oxyF32 b) -> oxyVec3;
-inline auto operator/(const oxyVec3& a, oxyF32 b) -> oxyVec3;
-
-inline auto operator-(const oxyVec4& a) -> oxyVec4;
-inline auto operator+(const oxyVec4& a, const oxyVec4& b) -> oxyVec4;
-inline auto operator-(const oxyVec4& a, const oxyVec4& b) -> oxyVec4;
-inline auto operator*(const oxyVec4& a, const oxyVec4& b) -> oxyVec4;
-inline auto operator/(const oxyVec4& a, const oxyVec4& b) -> oxyVec4;
-inline auto operator*(const oxyVec4& a, oxyF32 b) -> oxyVec4;
-inline auto operator/(const oxyVec4& a, oxyF32 b) -> oxyVec4;
-
-inline auto operator*(const oxyMat4x4& a, const oxyMat4x4& b) -> oxyMat4x4;
-inline auto operator*(const oxyMat4x4& a, const oxyVec4& b) -> oxyVec4;
-
-inline auto operator*(const oxyQuat& a, const oxyQuat& b) -> oxyQuat;
-inline auto operator*(const oxyQuat& a, const oxyVec3& b) -> oxyVec3;
-inline auto operator*(const oxyQuat& a, const oxyMat4x4& b) -> oxyMat4x4;
+constexpr auto operator-(const oxyVec2& a) -> oxyVec2;
+constexpr auto operator+(const oxyVec2& a, const oxyVec2& b) -> oxyVec2;
+constexpr auto operator-(const oxyVec2& a, const oxyVec2& b) -> oxyVec2;
+constexpr auto operator*(const oxyVec2& a, const oxyVec2& b) -> oxyVec2;
+constexpr auto operator/(const oxyVec2& a, const oxyVec2& b) -> oxyVec2;
+constexpr auto operator*(const oxyVec2& a, oxyF32 b) -> oxyVec2;
+constexpr auto operator/(const oxyVec2& a, oxyF32 b) -> oxyVec2;
+
+constexpr auto operator-(const oxyVec3& a) -> oxyVec3;
+constexpr auto operator+(const oxyVec3& a, const oxyVec3& b) -> oxyVec3;
+constexpr auto operator-(const oxyVec3& a, const oxyVec3& b) -> oxyVec3;
+constexpr auto operator*(const oxyVec3& a, const oxyVec3& b) -> oxyVec3;
+constexpr auto operator/(const oxyVec3& a, const oxyVec3& b) -> oxyVec3;
+constexpr auto operator*(const oxyVec3& a, oxyF32 b) -> oxyVec3;
+constexpr auto operator/(const oxyVec3& a, oxyF32 b) -> oxyVec3;
+
+constexpr auto operator-(const oxyVec4& a) -> oxyVec4;
+constexpr auto operator+(const oxyVec4& a, const oxyVec4& b) -> oxyVec4;
+constexpr auto operator-(const oxyVec4& a, const oxyVec4& b) -> oxyVec4;
+constexpr auto operator*(const oxyVec4& a, const oxyVec4& b) -> oxyVec4;
+constexpr auto operator/(const oxyVec4& a, const oxyVec4& b) -> oxyVec4;
+constexpr auto operator*(const oxyVec4& a, oxyF32 b) -> oxyVec4;
+constexpr auto operator/(const oxyVec4& a, oxyF32 b) -> oxyVec4;
+
+constexpr auto operator*(const oxyMat4x4& a, const oxyMat4x4& b) -> oxyMat4x4;
+constexpr auto operator*(const oxyMat4x4& a, const oxyVec4& b) -> oxyVec4;
+
+constexpr auto operator*(const oxyQuat& a, const oxyQuat& b) -> oxyQuat;
+constexpr auto operator*(const oxyQuat& a, const oxyVec3& b) -> oxyVec3;
+constexpr auto operator*(const oxyQuat& a, const oxyMat4x4& b) -> oxyMat4x4;
 
 struct oxyVec2
 {
 	oxyF32 x, y;
 
-	auto MagnitudeSquared() const -> oxyF32
+	constexpr auto MagnitudeSquared() const -> oxyF32
 	{
 		return x * x + y * y;
 	}
-	auto Magnitude() const -> oxyF32
+	constexpr auto Magnitude() const -> oxyF32
 	{
-		return std::sqrtf(x * x + y * y);
+		return oxygen::Math::Sqrt(x * x + y * y);
 	}
 
-	auto Normalized() const -> oxyVec2
+	/**
+	 * @brief A selects the reciprocal square root, see Math::Accuracy. Zero
+	 * length gives non-finite values, SafeNormalized does not.
+	 */
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto Normalized() const -> oxyVec2
+	{
+		const auto inv = oxygen::Math::RSqrt<A>(MagnitudeSquared());
+		return {x * inv, y * inv};
+	}
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto Normalize() -> oxyVec2&
 	{
-		oxyF32 mag = Magnitude();
-		return {x / mag, y / mag};
+		*this = Normalized<A>();
+		return *this;
+	}
+
+	/**
+	 * @brief Normalized, or zero when shorter than Math::k_minLengthSquared.
+	 */
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto SafeNormalized() const -> oxyVec2
+	{
+		const auto inv = oxygen::Math::SafeRSqrt<A>(MagnitudeSquared());
+		return {x * inv, y * inv};
 	}
-	auto Normalize() -> oxyVec2&
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto SafeNormalize() -> oxyVec2&
 	{
-		oxyF32 mag = Magnitude();
-		x /= mag;
-		y /= mag;
+		*this = SafeNormalized<A>();
 		return *this;
 	}
 
-	auto DotProduct(const oxyVec2& other) const -> oxyF32
+	constexpr auto DotProduct(const oxyVec2& other) const -> oxyF32
 	{
 		return x * other.x + y * other.y;
 	}
 
-	auto CrossProduct(const oxyVec2& other) const -> oxyF32
+	constexpr auto CrossProduct(const oxyVec2& other) const -> oxyF32
 	{
 		return x * other.y - y * other.x;
 	}
 
-	auto Conjugate() const -> oxyVec2
+	constexpr auto Conjugate() const -> oxyVec2
 	{
 		return {-x, -y};
 	}
 
-	auto Inversed() const -> oxyVec2
+	constexpr auto Inversed() const -> oxyVec2
 	{
 		return Conjugate() / (x * x + y * y);
 	}
-	auto Inverse() -> oxyVec2&
+	constexpr auto Inverse() -> oxyVec2&
 	{
 		*this = Inversed();
 		return *this;
 	}
 
-	auto operator+=(const oxyVec2& other) -> oxyVec2&
+	constexpr auto operator+=(const oxyVec2& other) -> oxyVec2&
 	{
 		*this = *this + other;
 		return *this;
 	}
-	auto operator-=(const oxyVec2& other) -> oxyVec2&
+	constexpr auto operator-=(const oxyVec2& other) -> oxyVec2&
 	{
 		*this = *this - other;
 		return *this;
 	}
-	auto operator*=(const oxyVec2& other) -> oxyVec2&
+	constexpr auto operator*=(const oxyVec2& other) -> oxyVec2&
 	{
 		*this = *this * other;
 		return *this;
 	}
-	auto operator/=(const oxyVec2& other) -> oxyVec2&
+	constexpr auto operator/=(const oxyVec2& other) -> oxyVec2&
 	{
 		*this = *this / other;
 		return *this;
 	}
-	auto operator*=(oxyF32 other) -> oxyVec2&
+	constexpr auto operator*=(oxyF32 other) -> oxyVec2&
 	{
 		*this = *this * other;
 		return *this;
 	}
-	auto operator/=(oxyF32 other) -> oxyVec2&
+	constexpr auto operator/=(oxyF32 other) -> oxyVec2&
 	{
 		*this = *this / other;
 		return *this;
@@ -137,172 +306,202 @@ struct oxyVec3
 {
 	oxyF32 x, y, z;
 
-	auto MagnitudeSquared() const -> oxyF32
+	constexpr auto MagnitudeSquared() const -> oxyF32
 	{
 		return x * x + y * y + z * z;
 	}
-	auto Magnitude() const -> oxyF32
+	constexpr auto Magnitude() const -> oxyF32
 	{
-		return std::sqrtf(x * x + y * y + z * z);
+		return oxygen::Math::Sqrt(x * x + y * y + z * z);
 	}
 
-	auto Normalized() const -> oxyVec3
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto Normalized() const -> oxyVec3
 	{
-		oxyF32 mag = Magnitude();
-		return {x / mag, y / mag, z / mag};
+		const auto inv = oxygen::Math::RSqrt<A>(MagnitudeSquared());
+		return {x * inv, y * inv, z * inv};
 	}
-	auto Normalize() -> oxyVec3&
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto Normalize() -> oxyVec3&
 	{
-		oxyF32 mag = Magnitude();
-		x /= mag;
-		y /= mag;
-		z /= mag;
+		*this = Normalized<A>();
 		return *this;
 	}
 
-	auto DotProduct(const oxyVec3& other) const -> oxyF32
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto SafeNormalized() const -> oxyVec3
+	{
+		const auto inv = oxygen::Math::SafeRSqrt<A>(MagnitudeSquared());
+		return {x * inv, y * inv, z * inv};
+	}
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto SafeNormalize() -> oxyVec3&
+	{
+		*this = SafeNormalized<A>();
+		return *this;
+	}
+
+	constexpr auto DotProduct(const oxyVec3& other) const -> oxyF32
 	{
 		return x * other.x + y * other.y + z * other.z;
 	}
 
-	auto CrossProduct(const oxyVec3& other) const -> oxyVec3
+	constexpr auto CrossProduct(const oxyVec3& other) const -> oxyVec3
 	{
 		return {y * other.z - z * other.y, z * other.x - x * other.z,
 				x * other.y - y * other.x};
 	}
 
-	auto Conjugate() const -> oxyVec3
+	constexpr auto Conjugate() const -> oxyVec3
 	{
 		return {-x, -y, z};
 	}
 
-	auto Inversed() const -> oxyVec3
+	constexpr auto Inversed() const -> oxyVec3
 	{
 		return Conjugate() / (x * x + y * y + z * z);
 	}
-	auto Inverse() -> oxyVec3&
+	constexpr auto Inverse() -> oxyVec3&
 	{
 		*this = Inversed();
 		return *this;
 	}
 
-	auto operator+=(const oxyVec3& other) -> oxyVec3&
+	constexpr auto operator+=(const oxyVec3& other) -> oxyVec3&
 	{
 		*this = *this + other;
 		return *this;
 	}
-	auto operator-=(const oxyVec3& other) -> oxyVec3&
+	constexpr auto operator-=(const oxyVec3& other) -> oxyVec3&
 	{
 		*this = *this - other;
 		return *this;
 	}
-	auto operator*=(const oxyVec3& other) -> oxyVec3&
+	constexpr auto operator*=(const oxyVec3& other) -> oxyVec3&
 	{
 		*this = *this * other;
 		return *this;
 	}
-	auto operator/=(const oxyVec3& other) -> oxyVec3&
+	constexpr auto operator/=(const oxyVec3& other) -> oxyVec3&
 	{
 		*this = *this / other;
 		return *this;
 	}
-	auto operator*=(oxyF32 other) -> oxyVec3&
+	constexpr auto operator*=(oxyF32 other) -> oxyVec3&
 	{
 		*this = *this * other;
 		return *this;
 	}
-	auto operator/=(oxyF32 other) -> oxyVec3&
+	constexpr auto operator/=(oxyF32 other) -> oxyVec3&
 	{
 		*this = *this / other;
 		return *this;
 	}
 };
 
-struct oxyVec4
+struct alignas(16) oxyVec4
 {
 	oxyF32 x, y, z, w;
 
-	auto MagnitudeSquared() const -> oxyF32
+	constexpr auto MagnitudeSquared() const -> oxyF32
+	{
+		return DotProduct(*this);
+	}
+	constexpr auto Magnitude() const -> oxyF32
+	{
+		return oxygen::Math::Sqrt(MagnitudeSquared());
+	}
+
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto Normalized() const -> oxyVec4
 	{
-		return x * x + y * y + z * z + w * w;
+		const auto inv = oxygen::Math::RSqrt<A>(MagnitudeSquared());
+		return {x * inv, y * inv, z * inv, w * inv};
 	}
-	auto Magnitude() const -> oxyF32
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto Normalize() -> oxyVec4&
 	{
-		return std::sqrtf(x * x + y * y + z * z + w * w);
+		*this = Normalized<A>();
+		return *this;
 	}
 
-	auto Normalized() const -> oxyVec4
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto SafeNormalized() const -> oxyVec4
 	{
-		oxyF32 mag = Magnitude();
-		return {x / mag, y / mag, z / mag, w / mag};
+		const auto inv = oxygen::Math::SafeRSqrt<A>(MagnitudeSquared());
+		return {x * inv, y * inv, z * inv, w * inv};
 	}
-	auto Normalize() -> oxyVec4&
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto SafeNormalize() -> oxyVec4&
 	{
-		oxyF32 mag = Magnitude();
-		x /= mag;
-		y /= mag;
-		z /= mag;
-		w /= mag;
+		*this = SafeNormalized<A>();
 		return *this;
 	}
 
-	auto DotProduct(const oxyVec4& other) const -> oxyF32
+	constexpr auto DotProduct(const oxyVec4& other) const -> oxyF32
 	{
-		return x * other.x + y * other.y + z * other.z + w * other.w;
+		if (std::is_constant_evaluated())
+			return x * other.x + y * other.y + z * other.z + w * other.w;
+		using namespace oxygen::Math;
+		return Simd::Dot4(Simd::Load(&x), Simd::Load(&other.x));
 	}
 
-	auto Conjugate() const -> oxyVec4
+	constexpr auto Conjugate() const -> oxyVec4
 	{
 		return {-x, -y, -z, w};
 	}
 
-	auto Inversed() const -> oxyVec4
+	constexpr auto Inversed() const -> oxyVec4
 	{
 		return Conjugate() / (x * x + y * y + z * z + w * w);
 	}
-	auto Inverse() -> oxyVec4&
+	constexpr auto Inverse() -> oxyVec4&
 	{
 		*this = Inversed();
 		return *this;
 	}
 
-	auto operator+=(const oxyVec4& other) -> oxyVec4&
+	constexpr auto operator+=(const oxyVec4& other) -> oxyVec4&
 	{
 		*this = *this + other;
 		return *this;
 	}
-	auto operator-=(const oxyVec4& other) -> oxyVec4&
+	constexpr auto operator-=(const oxyVec4& other) -> oxyVec4&
 	{
 		*this = *this - other;
 		return *this;
 	}
-	auto operator*=(const oxyVec4& other) -> oxyVec4&
+	constexpr auto operator*=(const oxyVec4& other) -> oxyVec4&
 	{
 		*this = *this * other;
 		return *this;
 	}
-	auto operator/=(const oxyVec4& other) -> oxyVec4&
+	constexpr auto operator/=(const oxyVec4& other) -> oxyVec4&
 	{
 		*this = *this / other;
 		return *this;
 	}
-	auto operator*=(oxyF32 other) -> oxyVec4&
+	constexpr auto operator*=(oxyF32 other) -> oxyVec4&
 	{
 		*this = *this * other;
 		return *this;
 	}
-	auto operator/=(oxyF32 other) -> oxyVec4&
+	constexpr auto operator/=(oxyF32 other) -> oxyVec4&
 	{
 		*this = *this / other;
 		return *this;
 	}
 };
 
-struct oxyMat4x4
+/**
+ * @brief Row major, vectors are transformed as rows: v' = v * M. Each row is
+ * 16 byte aligned for SIMD loads.
+ */
+struct alignas(16) oxyMat4x4
 {
 	oxyF32 m[4][4];
 
-	auto Determinant() const -> oxyF32
+	constexpr auto Determinant() const -> oxyF32
 	{
 		return m[0][0] * m[1][1] * m[2][2] * m[3][3] +
 			   m[0][0] * m[1][2] * m[2][3] * m[3][1] +
@@ -330,40 +529,69 @@ struct oxyMat4x4
 			   m[0][3] * m[1][2] * m[2][0] * m[3][1];
 	}
 
-	auto Transposed() const -> oxyMat4x4
+	constexpr auto Transposed() const -> oxyMat4x4
 	{
-		oxyMat4x4 result;
-		for (int i = 0; i < 4; i++)
+		if (std::is_constant_evaluated())
 		{
-			for (int j = 0; j < 4; j++)
+			oxyMat4x4 result{};
+			for (int i = 0; i < 4; i++)
 			{
-				result.m[i][j] = m[j][i];
+				for (int j = 0; j < 4; j++)
+					result.m[i][j] = m[j][i];
 			}
+			return result;
 		}
+		using namespace oxygen::Math;
+		auto r0 = Simd::Load(m[0]);
+		auto r1 = Simd::Load(m[1]);
+		auto r2 = Simd::Load(m[2]);
+		auto r3 = Simd::Load(m[3]);
+		Simd::Transpose(r0, r1, r2, r3);
+		oxyMat4x4 result{};
+		Simd::Store(result.m[0], r0);
+		Simd::Store(result.m[1], r1);
+		Simd::Store(result.m[2], r2);
+		Simd::Store(result.m[3], r3);
 		return result;
 	}
-	auto Transpose() -> oxyMat4x4&
+	constexpr auto Transpose() -> oxyMat4x4&
 	{
 		*this = Transposed();
 		return *this;
 	}
 
-	auto operator[](int i) -> oxyF32*
+	/**
+	 * @brief General inverse. See Math::InverseAffine and Math::InverseRigid
+	 * for cheaper paths. A singular matrix gives non-finite values.
+	 */
+	auto Inversed() const -> oxyMat4x4
+	{
+		oxyMat4x4 result;
+		oxygen::Math::Simd::Inverse4x4(m[0], result.m[0]);
+		return result;
+	}
+	auto Inverse() -> oxyMat4x4&
+	{
+		oxygen::Math::Simd::Inverse4x4(m[0], m[0]);
+		return *this;
+	}
+
+	constexpr auto operator[](int i) -> oxyF32*
 	{
 		return m[i];
 	}
-	auto operator[](int i) const -> const oxyF32*
+	constexpr auto operator[](int i) const -> const oxyF32*
 	{
 		return m[i];
 	}
 
-	auto operator*=(const oxyMat4x4& other) -> oxyMat4x4&
+	constexpr auto operator*=(const oxyMat4x4& other) -> oxyMat4x4&
 	{
 		*this = *this * other;
 		return *this;
 	}
 
-	static inline auto Identity() -> oxyMat4x4
+	static constexpr auto Identity() -> oxyMat4x4
 	{
 		oxyMat4x4 result{};
 		result.m[0][0] = 1;
@@ -374,192 +602,333 @@ struct oxyMat4x4
 	}
 };
 
-struct oxyQuat
+struct alignas(16) oxyQuat
 {
 	oxyF32 x, y, z, w;
 
-	auto MagnitudeSquared() const -> oxyF32
+	constexpr auto MagnitudeSquared() const -> oxyF32
 	{
-		return x * x + y * y + z * z + w * w;
+		return DotProduct(*this);
 	}
-	auto Magnitude() const -> oxyF32
+	constexpr auto Magnitude() const -> oxyF32
 	{
-		return std::sqrtf(x * x + y * y + z * z + w * w);
+		return oxygen::Math::Sqrt(MagnitudeSquared());
 	}
 
-	auto Normalized() const -> oxyQuat
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto Normalized() const -> oxyQuat
 	{
-		oxyF32 mag = Magnitude();
-		return {x / mag, y / mag, z / mag, w / mag};
+		const auto inv = oxygen::Math::RSqrt<A>(MagnitudeSquared());
+		return {x * inv, y * inv, z * inv, w * inv};
 	}
-	auto Normalize() -> oxyQuat&
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto Normalize() -> oxyQuat&
 	{
-		oxyF32 mag = Magnitude();
-		x /= mag;
-		y /= mag;
-		z /= mag;
-		w /= mag;
+		*this = Normalized<A>();
 		return *this;
 	}
 
-	auto DotProduct(const oxyQuat& other) const -> oxyF32
+	/**
+	 * @brief Normalized, or the identity when shorter than
+	 * Math::k_minLengthSquared. No branches.
+	 */
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto SafeNormalized() const -> oxyQuat
+	{
+		using namespace oxygen::Math;
+		if (std::is_constant_evaluated())
+		{
+			const auto inv = SafeRSqrt<A>(MagnitudeSquared());
+			if (inv == 0.0f)
+				return {0.0f, 0.0f, 0.0f, 1.0f};
+			return {x * inv, y * inv, z * inv, w * inv};
+		}
+		const auto q = Simd::Load(&x);
+		const auto lengthSquared = Simd::Splat(Simd::Dot4(q, q));
+		const auto valid =
+			Simd::CmpGe(lengthSquared, Simd::Splat(k_minLengthSquared));
+		oxyQuat result{};
+		Simd::Store(&result.x,
+					Simd::Select(valid,
+								 Simd::Mul(q, Simd::RSqrt<A>(lengthSquared)),
+								 Simd::Set(0.0f, 0.0f, 0.0f, 1.0f)));
+		return result;
+	}
+	template <oxygen::Math::Accuracy A = oxygen::Math::k_defaultAccuracy>
+	constexpr auto SafeNormalize() -> oxyQuat&
 	{
-		return x * other.x + y * other.y + z * other.z + w * other.w;
+		*this = SafeNormalized<A>();
+		return *this;
 	}
 
-	auto Conjugate() const -> oxyQuat
+	constexpr auto DotProduct(const oxyQuat& other) const -> oxyF32
+	{
+		if (std::is_constant_evaluated())
+			return x * other.x + y * other.y + z * other.z + w * other.w;
+		using namespace oxygen::Math;
+		return Simd::Dot4(Simd::Load(&x), Simd::Load(&other.x));
+	}
+
+	constexpr auto Conjugate() const -> oxyQuat
 	{
 		return {-x, -y, -z, w};
 	}
 
-	auto Inversed() const -> oxyQuat
+	constexpr auto Inversed() const -> oxyQuat
 	{
 		const auto conj = Conjugate();
 		const auto magsq = MagnitudeSquared();
 		return {conj.x / magsq, conj.y / magsq, conj.z / magsq, conj.w / magsq};
 	}
-	auto Inverse() -> oxyQuat&
+	constexpr auto Inverse() -> oxyQuat&
 	{
 		*this = Inversed();
 		return *this;
 	}
 
-	auto operator*=(const oxyQuat& other) -> oxyQuat&
+	constexpr auto operator*=(const oxyQuat& other) -> oxyQuat&
 	{
 		*this = *this * other;
 		return *this;
 	}
 };
 
-inline auto operator-(const oxyVec2& a) -> oxyVec2
+constexpr auto operator-(const oxyVec2& a) -> oxyVec2
 {
 	return {-a.x, -a.y};
 }
-inline auto operator+(const oxyVec2& a, const oxyVec2& b) -> oxyVec2
+constexpr auto operator+(const oxyVec2& a, const oxyVec2& b) -> oxyVec2
 {
 	return {a.x + b.x, a.y + b.y};
 }
-inline auto operator-(const oxyVec2& a, const oxyVec2& b) -> oxyVec2
+constexpr auto operator-(const oxyVec2& a, const oxyVec2& b) -> oxyVec2
 {
 	return {a.x - b.x, a.y - b.y};
 }
-inline auto operator*(const oxyVec2& a, const oxyVec2& b) -> oxyVec2
+constexpr auto operator*(const oxyVec2& a, const oxyVec2& b) -> oxyVec2
 {
 	return {a.x * b.x, a.y * b.y};
 }
-inline auto operator/(const oxyVec2& a, const oxyVec2& b) -> oxyVec2
+constexpr auto operator/(const oxyVec2& a, const oxyVec2& b) -> oxyVec2
 {
 	return {a.x / b.x, a.y / b.y};
 }
-inline auto operator*(const oxyVec2& a, oxyF32 b) -> oxyVec2
+constexpr auto operator*(const oxyVec2& a, oxyF32 b) -> oxyVec2
 {
 	return {a.x * b, a.y * b};
 }
-inline auto operator/(const oxyVec2& a, oxyF32 b) -> oxyVec2
+constexpr auto operator/(const oxyVec2& a, oxyF32 b) -> oxyVec2
 {
 	return {a.x / b, a.y / b};
 }
 
-inline auto operator-(const oxyVec3& a) -> oxyVec3
+constexpr auto operator-(const oxyVec3& a) -> oxyVec3
 {
 	return {-a.x, -a.y, -a.z};
 }
-inline auto operator+(const oxyVec3& a, const oxyVec3& b) -> oxyVec3
+constexpr auto operator+(const oxyVec3& a, const oxyVec3& b) -> oxyVec3
 {
 	return {a.x + b.x, a.y + b.y, a.z + b.z};
 }
-inline auto operator-(const oxyVec3& a, const oxyVec3& b) -> oxyVec3
+constexpr auto operator-(const oxyVec3& a, const oxyVec3& b) -> oxyVec3
 {
 	return {a.x - b.x, a.y - b.y, a.z - b.z};
 }
-inline auto operator*(const oxyVec3& a, const oxyVec3& b) -> oxyVec3
+constexpr auto operator*(const oxyVec3& a, const oxyVec3& b) -> oxyVec3
 {
 	return {a.x * b.x, a.y * b.y, a.z * b.z};
 }
-inline auto operator/(const oxyVec3& a, const oxyVec3& b) -> oxyVec3
+constexpr auto operator/(const oxyVec3& a, const oxyVec3& b) -> oxyVec3
 {
 	return {a.x / b.x, a.y / b.y, a.z / b.z};
 }
-inline auto operator*(const oxyVec3& a, oxyF32 b) -> oxyVec3
+constexpr auto operator*(const oxyVec3& a, oxyF32 b) -> oxyVec3
 {
 	return {a.x * b, a.y * b, a.z * b};
 }
-inline auto operator/(const oxyVec3& a, oxyF32 b) -> oxyVec3
+constexpr auto operator/(const oxyVec3& a, oxyF32 b) -> oxyVec3
 {
 	return {a.x / b, a.y / b, a.z / b};
 }
 
-inline auto operator-(const oxyVec4& a) -> oxyVec4
+namespace oxygen
 {
-	return {-a.x, -a.y, -a.z, -a.w};
+	namespace Math
+	{
+		inline auto ToSimd(const oxyVec4& v) -> Simd::Float4
+		{
+			return Simd::Load(&v.x);
+		}
+		inline auto ToSimd(const oxyQuat& q) -> Simd::Float4
+		{
+			return Simd::Load(&q.x);
+		}
+		inline auto ToSimd(const oxyVec3& v) -> Simd::Float4
+		{
+			return Simd::Set(v.x, v.y, v.z, 0.0f);
+		}
+		inline auto ToVec4(Simd::Float4 v) -> oxyVec4
+		{
+			oxyVec4 result;
+			Simd::Store(&result.x, v);
+			return result;
+		}
+		inline auto ToQuat(Simd::Float4 v) -> oxyQuat
+		{
+			oxyQuat result;
+			Simd::Store(&result.x, v);
+			return result;
+		}
+		inline auto ToVec3(Simd::Float4 v) -> oxyVec3
+		{
+			const auto result = ToVec4(v);
+			return {result.x, result.y, result.z};
+		}
+	}; // namespace Math
+};	   // namespace oxygen
+
+constexpr auto operator-(const oxyVec4& a) -> oxyVec4
+{
+	if (std::is_constant_evaluated())
+		return {-a.x, -a.y, -a.z, -a.w};
+	using namespace oxygen::Math;
+	return ToVec4(Simd::Sub(Simd::Splat(0.0f), ToSimd(a)));
 }
-inline auto operator+(const oxyVec4& a, const oxyVec4& b) -> oxyVec4
+constexpr auto operator+(const oxyVec4& a, const oxyVec4& b) -> oxyVec4
 {
-	return {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w};
+	if (std::is_constant_evaluated())
+		return {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w};
+	using namespace oxygen::Math;
+	return ToVec4(Simd::Add(ToSimd(a), ToSimd(b)));
 }
-inline auto operator-(const oxyVec4& a, const oxyVec4& b) -> oxyVec4
+constexpr auto operator-(const oxyVec4& a, const oxyVec4& b) -> oxyVec4
 {
-	return {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w};
+	if (std::is_constant_evaluated())
+		return {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w};
+	using namespace oxygen::Math;
+	return ToVec4(Simd::Sub(ToSimd(a), ToSimd(b)));
 }
-inline auto operator*(const oxyVec4& a, const oxyVec4& b) -> oxyVec4
+constexpr auto operator*(const oxyVec4& a, const oxyVec4& b) -> oxyVec4
 {
-	return {a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w};
+	if (std::is_constant_evaluated())
+		return {a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w};
+	using namespace oxygen::Math;
+	return ToVec4(Simd::Mul(ToSimd(a), ToSimd(b)));
 }
-inline auto operator/(const oxyVec4& a, const oxyVec4& b) -> oxyVec4
+constexpr auto operator/(const oxyVec4& a, const oxyVec4& b) -> oxyVec4
 {
-	return {a.x / b.x, a.y / b.y, a.z / b.z, a.w / b.w};
+	if (std::is_constant_evaluated())
+		return {a.x / b.x, a.y / b.y, a.z / b.z, a.w / b.w};
+	using namespace oxygen::Math;
+	return ToVec4(Simd::Div(ToSimd(a), ToSimd(b)));
 }
-inline auto operator*(const oxyVec4& a, oxyF32 b) -> oxyVec4
+constexpr auto operator*(const oxyVec4& a, oxyF32 b) -> oxyVec4
 {
-	return {a.x * b, a.y * b, a.z * b, a.w * b};
+	if (std::is_constant_evaluated())
+		return {a.x * b, a.y * b, a.z * b, a.w * b};
+	using namespace oxygen::Math;
+	return ToVec4(Simd::Mul(ToSimd(a), Simd::Splat(b)));
 }
-inline auto operator/(const oxyVec4& a, oxyF32 b) -> oxyVec4
+constexpr auto operator/(const oxyVec4& a, oxyF32 b) -> oxyVec4
 {
-	return {a.x / b, a.y / b, a.z / b, a.w / b};
+	if (std::is_constant_evaluated())
+		return {a.x / b, a.y / b, a.z / b, a.w / b};
+	using namespace oxygen::Math;
+	return ToVec4(Simd::Div(ToSimd(a), Simd::Splat(b)));
 }
 
-inline auto operator*(const oxyMat4x4& a, const oxyMat4x4& b) -> oxyMat4x4
+constexpr auto operator*(const oxyMat4x4& a, const oxyMat4x4& b) -> oxyMat4x4
 {
-	oxyMat4x4 result;
-	for (int i = 0; i < 4; i++)
+	oxyMat4x4 result{};
+	if (std::is_constant_evaluated())
 	{
-		for (int j = 0; j < 4; j++)
+		for (int i = 0; i < 4; i++)
 		{
-			result.m[i][j] = a.m[i][0] * b.m[0][j] + a.m[i][1] * b.m[1][j] +
-							 a.m[i][2] * b.m[2][j] + a.m[i][3] * b.m[3][j];
+			for (int j = 0; j < 4; j++)
+			{
+				for (int k = 0; k < 4; k++)
+					result.m[i][j] += a.m[i][k] * b.m[k][j];
+			}
 		}
+		return result;
 	}
+	oxygen::Math::Simd::Multiply4x4(a.m[0], b.m[0], result.m[0]);
 	return result;
 }
-inline auto operator*(const oxyMat4x4& a, const oxyVec4& b) -> oxyVec4
+/**
+ * @brief Transforms b as a row vector, b * a.
+ */
+constexpr auto operator*(const oxyMat4x4& a, const oxyVec4& b) -> oxyVec4
 {
-	oxyVec4 result;
-	for (int i = 0; i < 4; i++)
+	if (std::is_constant_evaluated())
 	{
-		result.x += a.m[i][0] * b.x;
-		result.y += a.m[i][1] * b.y;
-		result.z += a.m[i][2] * b.z;
-		result.w += a.m[i][3] * b.w;
+		oxyF32 r[4]{};
+		for (int j = 0; j < 4; j++)
+		{
+			r[j] = b.x * a.m[0][j] + b.y * a.m[1][j] + b.z * a.m[2][j] +
+				   b.w * a.m[3][j];
+		}
+		return {r[0], r[1], r[2], r[3]};
 	}
-	return result;
+	using namespace oxygen::Math;
+	const auto v = ToSimd(b);
+	auto r = Simd::Mul(Simd::SplatLane<0>(v), Simd::Load(a.m[0]));
+	r = Simd::MulAdd(Simd::SplatLane<1>(v), Simd::Load(a.m[1]), r);
+	r = Simd::MulAdd(Simd::SplatLane<2>(v), Simd::Load(a.m[2]), r);
+	r = Simd::MulAdd(Simd::SplatLane<3>(v), Simd::Load(a.m[3]), r);
+	return ToVec4(r);
 }
 
-inline auto operator*(const oxyQuat& a, const oxyQuat& b) -> oxyQuat
+constexpr auto operator*(const oxyQuat& a, const oxyQuat& b) -> oxyQuat
 {
-	return {a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
-			a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
-			a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
-			a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+	if (std::is_constant_evaluated())
+	{
+		return {a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+				a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+				a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+				a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+	}
+	using namespace oxygen::Math;
+	const auto qa = ToSimd(a);
+	const auto qb = ToSimd(b);
+	auto r = Simd::Mul(Simd::SplatLane<3>(qa), qb);
+	r = Simd::MulAdd(
+		Simd::SplatLane<0>(qa),
+		Simd::Mul(Simd::Permute<3, 2, 1, 0>(qb), Simd::Set(1, -1, 1, -1)), r);
+	r = Simd::MulAdd(
+		Simd::SplatLane<1>(qa),
+		Simd::Mul(Simd::Permute<2, 3, 0, 1>(qb), Simd::Set(1, 1, -1, -1)), r);
+	r = Simd::MulAdd(
+		Simd::SplatLane<2>(qa),
+		Simd::Mul(Simd::Permute<1, 0, 3, 2>(qb), Simd::Set(-1, 1, 1, -1)), r);
+	return ToQuat(r);
 }
-inline auto operator*(const oxyQuat& a, const oxyVec3& b) -> oxyVec3
+/**
+ * @brief Same result as a * v * a.Conjugate(), expanded to
+ * (w^2 - u.u) v + 2 (u.v) u + 2 w (u x v) with u the vector part of a.
+ */
+constexpr auto operator*(const oxyQuat& a, const oxyVec3& b) -> oxyVec3
 {
-	oxyQuat v = {b.x, b.y, b.z, 0};
-	oxyQuat result = a * v * a.Conjugate();
-	return {result.x, result.y, result.z};
+	if (std::is_constant_evaluated())
+	{
+		const oxyVec3 u{a.x, a.y, a.z};
+		return b * (a.w * a.w - u.DotProduct(u)) +
+			   u * (2.0f * u.DotProduct(b)) + u.CrossProduct(b) * (2.0f * a.w);
+	}
+	using namespace oxygen::Math;
+	const auto u = Simd::Set(a.x, a.y, a.z, 0.0f);
+	const auto v = ToSimd(b);
+	const auto w = Simd::Splat(a.w);
+	const auto uu = Simd::Splat(Simd::Dot4(u, u));
+	const auto uv = Simd::Splat(2.0f * Simd::Dot4(u, v));
+	auto r = Simd::Mul(Simd::Sub(Simd::Mul(w, w), uu), v);
+	r = Simd::MulAdd(uv, u, r);
+	r = Simd::MulAdd(Simd::Add(w, w), Simd::Cross3(u, v), r);
+	return ToVec3(r);
 }
-inline auto operator*(const oxyQuat& a, const oxyMat4x4& b) -> oxyMat4x4
+constexpr auto operator*(const oxyQuat& a, const oxyMat4x4& b) -> oxyMat4x4
 {
-	oxyMat4x4 result;
+	oxyMat4x4 result{};
 	result.m[0][0] = 1 - 2 * a.y * a.y - 2 * a.z * a.z;
 	result.m[0][1] = 2 * a.x * a.y - 2 * a.z * a.w;
 	result.m[0][2] = 2 * a.x * a.z + 2 * a.y * a.w;
@@ -579,11 +948,202 @@ inline auto operator*(const oxyQuat& a, const oxyMat4x4& b) -> oxyMat4x4
 	return result * b;
 }
 
+/**
+ * @brief Axis aligned box stored as center and half extents.
+ */
+struct oxyAABB
+{
+	oxyVec3 center;
+	oxyVec3 extents;
+
+	static inline auto FromMinMax(const oxyVec3& lower, const oxyVec3& upper)
+		-> oxyAABB
+	{
+		return {(lower + upper) * 0.5f, (upper - lower) * 0.5f};
+	}
+
+	auto Min() const -> oxyVec3
+	{
+		return center - extents;
+	}
+	auto Max() const -> oxyVec3
+	{
+		return center + extents;
+	}
+
+	auto Contains(const oxyVec3& point) const -> oxyBool
+	{
+		const auto d = point - center;
+		return std::fabs(d.x) <= extents.x && std::fabs(d.y) <= extents.y &&
+			   std::fabs(d.z) <= extents.z;
+	}
+
+	/**
+	 * @brief Smallest axis aligned box around this box transformed by m.
+	 */
+	auto Transformed(const oxyMat4x4& m) const -> oxyAABB
+	{
+		using namespace oxygen::Math;
+		const auto c = ToSimd(center);
+		const auto e = ToSimd(extents);
+		const auto r0 = Simd::Load(m.m[0]);
+		const auto r1 = Simd::Load(m.m[1]);
+		const auto r2 = Simd::Load(m.m[2]);
+		auto newCenter = Simd::MulAdd(Simd::SplatLane<0>(c), r0,
+									  Simd::Load(m.m[3]));
+		newCenter = Simd::MulAdd(Simd::SplatLane<1>(c), r1, newCenter);
+		newCenter = Simd::MulAdd(Simd::SplatLane<2>(c), r2, newCenter);
+		auto newExtents = Simd::Mul(Simd::SplatLane<0>(e), Simd::Abs(r0));
+		newExtents =
+			Simd::MulAdd(Simd::SplatLane<1>(e), Simd::Abs(r1), newExtents);
+		newExtents =
+			Simd::MulAdd(Simd::SplatLane<2>(e), Simd::Abs(r2), newExtents);
+		return {ToVec3(newCenter), ToVec3(newExtents)};
+	}
+};
+
+struct oxySphere
+{
+	oxyVec3 center;
+	oxyF32 radius;
+
+	static inline auto FromAABB(const oxyAABB& box) -> oxySphere
+	{
+		return {box.center, box.extents.Magnitude()};
+	}
+
+	/**
+	 * @brief Sphere around this sphere transformed by m, the radius is
+	 * scaled by the largest axis scale.
+	 */
+	auto Transformed(const oxyMat4x4& m) const -> oxySphere
+	{
+		using namespace oxygen::Math;
+		const auto r0 = Simd::Load(m.m[0]);
+		const auto r1 = Simd::Load(m.m[1]);
+		const auto r2 = Simd::Load(m.m[2]);
+		const auto scale2 = std::max({Simd::Dot3(r0, r0), Simd::Dot3(r1, r1),
+									  Simd::Dot3(r2, r2)});
+		const auto c = m * oxyVec4{center.x, center.y, center.z, 1.0f};
+		return {{c.x, c.y, c.z}, radius * oxygen::Math::Sqrt(scale2)};
+	}
+};
+
+/**
+ * @brief Box with half extents along the axes of rotation.
+ */
+struct oxyOBB
+{
+	oxyVec3 center;
+	oxyVec3 extents;
+	oxyQuat rotation;
+
+	/**
+	 * @brief Smallest axis aligned box around this box.
+	 */
+	auto ToAABB() const -> oxyAABB
+	{
+		const auto x = rotation * oxyVec3{extents.x, 0.0f, 0.0f};
+		const auto y = rotation * oxyVec3{0.0f, extents.y, 0.0f};
+		const auto z = rotation * oxyVec3{0.0f, 0.0f, extents.z};
+		return {center,
+				{std::fabs(x.x) + std::fabs(y.x) + std::fabs(z.x),
+				 std::fabs(x.y) + std::fabs(y.y) + std::fabs(z.y),
+				 std::fabs(x.z) + std::fabs(y.z) + std::fabs(z.z)}};
+	}
+};
+
+/**
+ * @brief Six planes (normal, distance) with normals pointing inside, in the
+ * order left, right, bottom, top, near, far. A point p is inside a plane when
+ * dot(normal, p) + distance >= 0.
+ */
+struct alignas(16) oxyFrustum
+{
+	oxyVec4 planes[6];
+
+	/**
+	 * @brief Extracts the planes of a row vector view projection matrix
+	 * with a [0, 1] clip depth range, such as
+	 * DebugCamera::m_viewProjectionMatrix. Planes are in world space.
+	 */
+	static inline auto FromViewProjection(const oxyMat4x4& m) -> oxyFrustum
+	{
+		using namespace oxygen::Math;
+		// Clip space tests use the columns of m
+		auto c0 = Simd::Load(m.m[0]);
+		auto c1 = Simd::Load(m.m[1]);
+		auto c2 = Simd::Load(m.m[2]);
+		auto c3 = Simd::Load(m.m[3]);
+		Simd::Transpose(c0, c1, c2, c3);
+		const Simd::Float4 planes[6]{
+			Simd::Add(c3, c0), Simd::Sub(c3, c0), Simd::Add(c3, c1),
+			Simd::Sub(c3, c1), c2,				  Simd::Sub(c3, c2),
+		};
+		oxyFrustum result;
+		for (int i = 0; i < 6; i++)
+		{
+			const auto length =
+				oxygen::Math::Sqrt(Simd::Dot3(planes[i], planes[i]));
+			result.planes[i] =
+				ToVec4(Simd::Div(planes[i], Simd::Splat(length)));
+		}
+		return result;
+	}
+
+	/**
+	 * @brief Conservative test, false only if the volume is completely
+	 * behind one of the planes.
+	 */
+	auto Intersects(const oxySphere& sphere) const -> oxyBool
+	{
+		const oxyVec4 p{sphere.center.x, sphere.center.y, sphere.center.z,
+						1.0f};
+		for (const auto& plane : planes)
+		{
+			if (plane.DotProduct(p) < -sphere.radius)
+				return false;
+		}
+		return true;
+	}
+	auto Intersects(const oxyAABB& box) const -> oxyBool
+	{
+		const oxyVec4 p{box.center.x, box.center.y, box.center.z, 1.0f};
+		for (const auto& plane : planes)
+		{
+			const auto radius = box.extents.x * std::fabs(plane.x) +
+								box.extents.y * std::fabs(plane.y) +
+								box.extents.z * std::fabs(plane.z);
+			if (plane.DotProduct(p) < -radius)
+				return false;
+		}
+		return true;
+	}
+	auto Intersects(const oxyOBB& box) const -> oxyBool
+	{
+		const auto x = box.rotation * oxyVec3{1.0f, 0.0f, 0.0f};
+		const auto y = box.rotation * oxyVec3{0.0f, 1.0f, 0.0f};
+		const auto z = box.rotation * oxyVec3{0.0f, 0.0f, 1.0f};
+		const oxyVec4 p{box.center.x, box.center.y, box.center.z, 1.0f};
+		for (const auto& plane : planes)
+		{
+			const oxyVec3 n{plane.x, plane.y, plane.z};
+			const auto radius = box.extents.x * std::fabs(n.DotProduct(x)) +
+								box.extents.y * std::fabs(n.DotProduct(y)) +
+								box.extents.z * std::fabs(n.DotProduct(z));
+			if (plane.DotProduct(p) < -radius)
+				return false;
+		}
+		return true;
+	}
+};
+
 namespace oxygen
 {
 	namespace Math
 	{
-		inline auto Translate(const oxyMat4x4& m, const oxyVec3& v) -> oxyMat4x4
+		constexpr auto Translate(const oxyMat4x4& m, const oxyVec3& v)
+			-> oxyMat4x4
 		{
 			oxyMat4x4 result = m;
 			result.m[3][0] += v.x;
@@ -591,9 +1151,9 @@ namespace oxygen
 			result.m[3][2] += v.z;
 			return result;
 		}
-		inline auto Rotate(const oxyMat4x4& m, const oxyQuat& q) -> oxyMat4x4
+		constexpr auto Rotate(const oxyMat4x4& m, const oxyQuat& q) -> oxyMat4x4
 		{
-			oxyMat4x4 result;
+			oxyMat4x4 result{};
 			result.m[0][0] = 1 - 2 * q.y * q.y - 2 * q.z * q.z;
 			result.m[0][1] = 2 * q.x * q.y - 2 * q.z * q.w;
 			result.m[0][2] = 2 * q.x * q.z + 2 * q.y * q.w;
@@ -612,7 +1172,7 @@ namespace oxygen
 			result.m[3][3] = 1;
 			return result * m;
 		}
-		inline auto Scale(const oxyMat4x4& m, const oxyVec3& v) -> oxyMat4x4
+		constexpr auto Scale(const oxyMat4x4& m, const oxyVec3& v) -> oxyMat4x4
 		{
 			oxyMat4x4 result = m;
 			result.m[0][0] *= v.x;
@@ -620,8 +1180,73 @@ namespace oxygen
 			result.m[2][2] *= v.z;
 			return result;
 		}
-		inline auto LookAt(const oxyVec3& eye, const oxyVec3& center,
-						   const oxyVec3& up) -> oxyMat4x4
+		/**
+		 * @brief Inverse of the upper 3x3 with the translation row cleared.
+		 * Transforms normals by a matrix with non-uniform scale.
+		 */
+		inline auto InverseTranspose(const oxyMat4x4& m) -> oxyMat4x4
+		{
+			const auto r0 = Simd::Load(m.m[0]);
+			const auto r1 = Simd::Load(m.m[1]);
+			const auto r2 = Simd::Load(m.m[2]);
+			// Rows of the adjugate transpose are the cross products
+			const auto c0 = Simd::Cross3(r1, r2);
+			const auto c1 = Simd::Cross3(r2, r0);
+			const auto c2 = Simd::Cross3(r0, r1);
+			const auto invDet = Simd::Splat(1.0f / Simd::Dot4(r0, c0));
+			oxyMat4x4 result;
+			Simd::Store(result.m[0], Simd::Mul(c0, invDet));
+			Simd::Store(result.m[1], Simd::Mul(c1, invDet));
+			Simd::Store(result.m[2], Simd::Mul(c2, invDet));
+			Simd::Store(result.m[3], Simd::Set(0.0f, 0.0f, 0.0f, 1.0f));
+			return result;
+		}
+		/**
+		 * @brief Inverse of a matrix whose last column is (0, 0, 0, 1), such
+		 * as any composition of Translate, Rotate and Scale.
+		 */
+		inline auto InverseAffine(const oxyMat4x4& m) -> oxyMat4x4
+		{
+			auto result = InverseTranspose(m);
+			auto r0 = Simd::Load(result.m[0]);
+			auto r1 = Simd::Load(result.m[1]);
+			auto r2 = Simd::Load(result.m[2]);
+			auto r3 = Simd::Load(result.m[3]);
+			Simd::Transpose(r0, r1, r2, r3);
+			const auto t = Simd::Load(m.m[3]);
+			auto translation = Simd::Mul(Simd::SplatLane<0>(t), r0);
+			translation = Simd::MulAdd(Simd::SplatLane<1>(t), r1, translation);
+			translation = Simd::MulAdd(Simd::SplatLane<2>(t), r2, translation);
+			Simd::Store(result.m[0], r0);
+			Simd::Store(result.m[1], r1);
+			Simd::Store(result.m[2], r2);
+			Simd::Store(result.m[3], Simd::Sub(r3, translation));
+			return result;
+		}
+		/**
+		 * @brief Inverse of a rotation followed by a translation. The upper
+		 * 3x3 must be orthonormal, it is only transposed.
+		 */
+		inline auto InverseRigid(const oxyMat4x4& m) -> oxyMat4x4
+		{
+			auto r0 = Simd::Load(m.m[0]);
+			auto r1 = Simd::Load(m.m[1]);
+			auto r2 = Simd::Load(m.m[2]);
+			auto r3 = Simd::Set(0.0f, 0.0f, 0.0f, 1.0f);
+			const auto t = Simd::Load(m.m[3]);
+			Simd::Transpose(r0, r1, r2, r3);
+			auto translation = Simd::Mul(Simd::SplatLane<0>(t), r0);
+			translation = Simd::MulAdd(Simd::SplatLane<1>(t), r1, translation);
+			translation = Simd::MulAdd(Simd::SplatLane<2>(t), r2, translation);
+			oxyMat4x4 result;
+			Simd::Store(result.m[0], r0);
+			Simd::Store(result.m[1], r1);
+			Simd::Store(result.m[2], r2);
+			Simd::Store(result.m[3], Simd::Sub(r3, translation));
+			return result;
+		}
+		constexpr auto LookAt(const oxyVec3& eye, const oxyVec3& center,
+							  const oxyVec3& up) -> oxyMat4x4
 		{
 			const auto f = (center - eye).Normalized();
 			const auto s = f.CrossProduct(up).Normalized();
@@ -642,13 +1267,13 @@ namespace oxygen
 			result[3][3] = 1;
 			return result;
 		}
-		inline auto Perspective(oxyF32 fovy, oxyF32 aspect, oxyF32 near,
-								oxyF32 far) -> oxyMat4x4
+		constexpr auto Perspective(oxyF32 fovy, oxyF32 aspect, oxyF32 near,
+								   oxyF32 far) -> oxyMat4x4
 		{
-			const auto tanHalfFovy = std::tanf(fovy / 2.f);
+			const auto tanHalfFovy = Tan(fovy / 2.f);
 			oxyMat4x4 result{};
-			result[0][0] = 1.f / (aspect * std::tanf(fovy / 2.f));
-			result[1][1] = 1.f / std::tanf(fovy / 2.f);
+			result[0][0] = 1.f / (aspect * tanHalfFovy);
+			result[1][1] = 1.f / tanHalfFovy;
 			result[2][2] = far / (far - near);
 			result[2][3] = 1.f;
 			result[3][2] = -(far * near) / (far - near);
@@ -657,42 +1282,121 @@ namespace oxygen
 		inline auto RotationMatrixToEuler(const oxyMat4x4& m) -> oxyVec3
 		{
 			oxyVec3 result;
-			result.y = std::asin(-m[2][0]);
-			if (std::cos(result.y) != 0)
+			result.y = Asin(-m[2][0]);
+			if (Cos(result.y) != 0)
 			{
-				result.x = std::atan2(m[2][1], m[2][2]);
-				result.z = std::atan2(m[1][0], m[0][0]);
+				result.x = Atan2(m[2][1], m[2][2]);
+				result.z = Atan2(m[1][0], m[0][0]);
 			}
 			else
 			{
 				result.x = 0;
-				result.z = std::atan2(-m[0][1], m[1][1]);
+				result.z = Atan2(-m[0][1], m[1][1]);
 			}
 			return result;
 		}
-		inline auto AngleAxisToQuat(const oxyF32 angle, const oxyVec3& axis)
+		constexpr auto AngleAxisToQuat(const oxyF32 angle, const oxyVec3& axis)
 			-> oxyQuat
 		{
 			const auto halfAngle = angle / 2;
-			const auto s = std::sin(halfAngle);
-			return {axis.x * s, axis.y * s, axis.z * s, std::cos(halfAngle)};
+			const auto s = Sin(halfAngle);
+			return {axis.x * s, axis.y * s, axis.z * s, Cos(halfAngle)};
 		}
 		inline auto QuatToEulerAngles(const oxyQuat& q) -> oxyVec3
 		{
 			oxyVec3 result;
-			result.x = std::atan2(2 * (q.w * q.x + q.y * q.z),
-								  1 - 2 * (q.x * q.x + q.y * q.y));
-			result.y = std::asin(2 * (q.w * q.y - q.z * q.x));
-			result.z = std::atan2(2 * (q.w * q.z + q.x * q.y),
-								  1 - 2 * (q.y * q.y + q.z * q.z));
+			result.x = Atan2(2 * (q.w * q.x + q.y * q.z),
+							 1 - 2 * (q.x * q.x + q.y * q.y));
+			result.y = Asin(2 * (q.w * q.y - q.z * q.x));
+			result.z = Atan2(2 * (q.w * q.z + q.x * q.y),
+							 1 - 2 * (q.y * q.y + q.z * q.z));
 			return result;
 		}
-		inline auto EulerAnglesToQuat(const oxyVec3& v) -> oxyQuat
+		constexpr auto EulerAnglesToQuat(const oxyVec3& v) -> oxyQuat
 		{
 			const auto pitch = AngleAxisToQuat(v.x, {1, 0, 0});
 			const auto yaw = AngleAxisToQuat(v.y, {0, 1, 0});
 			const auto roll = AngleAxisToQuat(v.z, {0, 0, 1});
 			return pitch * yaw * roll;
 		}
+
+		/**
+		 * @brief Normalized linear interpolation along the shorter arc. The
+		 * cheapest blend, but the angular velocity is not constant.
+		 */
+		inline auto Nlerp(const oxyQuat& a, const oxyQuat& b, oxyF32 t)
+			-> oxyQuat
+		{
+			const auto wa = 1 - t;
+			const auto wb = a.DotProduct(b) < 0.0f ? -t : t;
+			const auto r = Simd::MulAdd(ToSimd(b), Simd::Splat(wb),
+										Simd::Mul(ToSimd(a), Simd::Splat(wa)));
+			return ToQuat(r).Normalized();
+		}
+		/**
+		 * @brief Spherical linear interpolation along the shorter arc.
+		 * Nearly parallel rotations fall back to Nlerp.
+		 */
+		inline auto Slerp(const oxyQuat& a, const oxyQuat& b, oxyF32 t)
+			-> oxyQuat
+		{
+			const auto cosTheta = a.DotProduct(b);
+			const auto sign = cosTheta < 0.0f ? -1.0f : 1.0f;
+			if (cosTheta * sign > 0.9995f)
+				return Nlerp(a, b, t);
+			const auto theta = Acos(cosTheta * sign);
+			const auto invSinTheta = 1.0f / Sin(theta);
+			const auto wa = Sin((1 - t) * theta) * invSinTheta;
+			const auto wb = Sin(t * theta) * invSinTheta * sign;
+			return ToQuat(Simd::MulAdd(ToSimd(b), Simd::Splat(wb),
+									   Simd::Mul(ToSimd(a), Simd::Splat(wa))));
+		}
+
+		// Series coefficients of sin(t * theta) / sin(theta) in
+		// (cos(theta) - 1), with the last term scaled to minimize the error
+		// for theta in [0, pi / 2]. From Eberly, "A Fast and Accurate
+		// Algorithm for Computing SLERP".
+		static inline constexpr oxyF32 k_slerpMu = 1.85298109240830f;
+		static inline constexpr oxyF32 k_slerpU[8]{
+			1.0f / 3,  1.0f / 10, 1.0f / 21,  1.0f / 36,
+			1.0f / 55, 1.0f / 78, 1.0f / 105, k_slerpMu / 136};
+		static inline constexpr oxyF32 k_slerpV[8]{
+			1.0f / 3,  2.0f / 5,  3.0f / 7,  4.0f / 9,
+			5.0f / 11, 6.0f / 13, 7.0f / 15, k_slerpMu * 8 / 17};
+
+		/**
+		 * @brief Slerp weights of a and b, sin((1 - t) * theta) / sin(theta)
+		 * and sin(t * theta) / sin(theta), from cos(theta) - 1. Within 2e-5
+		 * for theta in [0, pi / 2].
+		 */
+		inline auto SlerpWeights(oxyF32 t, oxyF32 cosThetaMinusOne) -> oxyVec2
+		{
+			const auto ta = 1 - t;
+			const auto ta2 = ta * ta;
+			const auto tb2 = t * t;
+			oxyF32 ra = 1.0f;
+			oxyF32 rb = 1.0f;
+			for (int i = 7; i >= 0; i--)
+			{
+				const auto x = cosThetaMinusOne;
+				ra = 1.0f + (k_slerpU[i] * ta2 - k_slerpV[i]) * x * ra;
+				rb = 1.0f + (k_slerpU[i] * tb2 - k_slerpV[i]) * x * rb;
+			}
+			return {ta * ra, t * rb};
+		}
+		/**
+		 * @brief Slerp without acos or sin and without branches on the
+		 * angle. Inputs must be normalized. Each component is within 4e-5 of
+		 * Slerp.
+		 */
+		inline auto SlerpFast(const oxyQuat& a, const oxyQuat& b, oxyF32 t)
+			-> oxyQuat
+		{
+			const auto cosTheta = a.DotProduct(b);
+			const auto sign = cosTheta < 0.0f ? -1.0f : 1.0f;
+			const auto w = SlerpWeights(t, cosTheta * sign - 1.0f);
+			return ToQuat(Simd::MulAdd(ToSimd(b), Simd::Splat(w.y * sign),
+									   Simd::Mul(ToSimd(a), Simd::Splat(w.x))));
+		}
 	}; // namespace Math
 };	   // namespace oxygen
\ No newline at end of file
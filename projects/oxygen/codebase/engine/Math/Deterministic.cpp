@@ -0,0 +1,189 @@
+#include "OxygenPCH.h"
+#include "Math/Deterministic.h"
+
+// Contraction into FMA would round differently per target, keep every
+// operation in this file separate whatever the build flags.
+#if defined(_MSC_VER) && !defined(__clang__)
+#pragma float_control(precise, on)
+#pragma fp_contract(off)
+#elif defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD != 0
+#error "Deterministic math needs doubles evaluated in double precision"
+#endif
+
+namespace oxygen
+{
+	namespace Math
+	{
+		namespace Deterministic
+		{
+			namespace
+			{
+				constexpr oxyF64 k_pi = 3.14159265358979311600;
+				constexpr oxyF64 k_halfPi = 1.57079632679489655800;
+				constexpr oxyF64 k_twoOverPi = 0.63661977236758138243;
+				// pi / 2 split in two, the first with 33 significant bits so
+				// k * k_halfPiHigh is exact for |k| < 2^20
+				constexpr oxyF64 k_halfPiHigh = 1.57079632673412561417;
+				constexpr oxyF64 k_halfPiLow = 6.07710050650619224932e-11;
+				constexpr oxyF64 k_sixthPi = 0.52359877559829881566;
+				constexpr oxyF64 k_tanTwelfthPi = 0.26794919243112270647;
+				constexpr oxyF64 k_sqrt3 = 1.73205080756887719318;
+
+				struct SinCosResult
+				{
+					oxyF64 m_sin;
+					oxyF64 m_cos;
+				};
+
+				/**
+				 * @brief Taylor series, |r| <= pi / 4 keeps the truncation
+				 * error near 1e-15.
+				 */
+				auto SinPoly(oxyF64 r) -> oxyF64
+				{
+					const auto r2 = r * r;
+					auto p = 1.0 / 6227020800.0;
+					p = p * r2 - 1.0 / 39916800.0;
+					p = p * r2 + 1.0 / 362880.0;
+					p = p * r2 - 1.0 / 5040.0;
+					p = p * r2 + 1.0 / 120.0;
+					p = p * r2 - 1.0 / 6.0;
+					return r + r * r2 * p;
+				}
+				auto CosPoly(oxyF64 r) -> oxyF64
+				{
+					const auto r2 = r * r;
+					auto p = -1.0 / 87178291200.0;
+					p = p * r2 + 1.0 / 479001600.0;
+					p = p * r2 - 1.0 / 3628800.0;
+					p = p * r2 + 1.0 / 40320.0;
+					p = p * r2 - 1.0 / 720.0;
+					p = p * r2 + 1.0 / 24.0;
+					p = p * r2 - 0.5;
+					return 1.0 + r2 * p;
+				}
+
+				/**
+				 * @brief Reduces x by the nearest multiple of pi / 2. Inputs
+				 * past 2^20 are first brought into [-2 pi, 2 pi] with fmod,
+				 * which is exact but loses their relation to the true angle.
+				 * Such arguments carry no useful phase in float anyway.
+				 */
+				auto SinCos(oxyF64 x) -> SinCosResult
+				{
+					if (!(std::fabs(x) < 1048576.0))
+						x = std::fmod(x, 2.0 * k_pi);
+					if (x != x)
+						return {x, x};
+					const auto k = std::floor(x * k_twoOverPi + 0.5);
+					const auto r = (x - k * k_halfPiHigh) - k * k_halfPiLow;
+					const auto s = SinPoly(r);
+					const auto c = CosPoly(r);
+					switch (static_cast<oxyS32>(k) & 3)
+					{
+					case 0:
+						return {s, c};
+					case 1:
+						return {c, -s};
+					case 2:
+						return {-s, -c};
+					default:
+						return {-c, s};
+					}
+				}
+
+				/**
+				 * @brief atan for 0 <= x <= 1. Above tan(pi / 12) the
+				 * argument is shifted by pi / 6, leaving |t| <= 0.268 for the
+				 * series.
+				 */
+				auto AtanUnit(oxyF64 x) -> oxyF64
+				{
+					auto offset = 0.0;
+					if (x > k_tanTwelfthPi)
+					{
+						x = (x * k_sqrt3 - 1.0) / (x + k_sqrt3);
+						offset = k_sixthPi;
+					}
+					const auto x2 = x * x;
+					auto p = 1.0 / 23.0;
+					for (int n = 10; n >= 0; n--)
+						p = 1.0 / (2 * n + 1) - p * x2;
+					return offset + x * p;
+				}
+
+				auto Atan2Double(oxyF64 y, oxyF64 x) -> oxyF64
+				{
+					if (x != x || y != y)
+						return x + y;
+					const auto ax = std::fabs(x);
+					const auto ay = std::fabs(y);
+					oxyF64 angle;
+					if (ay == 0.0)
+						angle = 0.0;
+					else if (ax == ay)
+						angle = 0.5 * k_halfPi;
+					else if (ay > ax)
+						angle = k_halfPi - AtanUnit(ax / ay);
+					else
+						angle = AtanUnit(ay / ax);
+					if (std::signbit(x))
+						angle = k_pi - angle;
+					return std::copysign(angle, y);
+				}
+			}; // namespace
+
+			auto Sqrt(oxyF32 x) -> oxyF32
+			{
+				// IEEE 754 requires a correctly rounded square root
+				return std::sqrt(x);
+			}
+
+			auto Sin(oxyF32 x) -> oxyF32
+			{
+				return static_cast<oxyF32>(SinCos(x).m_sin);
+			}
+
+			auto Cos(oxyF32 x) -> oxyF32
+			{
+				return static_cast<oxyF32>(SinCos(x).m_cos);
+			}
+
+			auto Tan(oxyF32 x) -> oxyF32
+			{
+				const auto sc = SinCos(x);
+				return static_cast<oxyF32>(sc.m_sin / sc.m_cos);
+			}
+
+			auto Asin(oxyF32 x) -> oxyF32
+			{
+				const oxyF64 d = x;
+				return static_cast<oxyF32>(
+					Atan2Double(d, std::sqrt((1.0 - d) * (1.0 + d))));
+			}
+
+			auto Acos(oxyF32 x) -> oxyF32
+			{
+				const oxyF64 d = x;
+				return static_cast<oxyF32>(
+					Atan2Double(std::sqrt((1.0 - d) * (1.0 + d)), d));
+			}
+
+			auto Atan(oxyF32 x) -> oxyF32
+			{
+				return static_cast<oxyF32>(Atan2Double(x, 1.0));
+			}
+
+			auto Atan2(oxyF32 y, oxyF32 x) -> oxyF32
+			{
+				return static_cast<oxyF32>(Atan2Double(y, x));
+			}
+		}; // namespace Deterministic
+	}; // namespace Math
+}; // namespace oxygen
@@ -0,0 +1,27 @@
+#pragma once
+
+namespace oxygen
+{
+	namespace Math
+	{
+		/**
+		 * @brief Portable replacements for the libm functions used by the
+		 * Math helpers. They are built only from IEEE 754 double additions,
+		 * multiplications, divisions and square roots in a fixed order, so a
+		 * given input produces the same bits with every compiler and CPU.
+		 * Errors are below one float ulp. The Math helpers use them when
+		 * OXYMATHDETERMINISTIC is defined.
+		 */
+		namespace Deterministic
+		{
+			auto Sqrt(oxyF32 x) -> oxyF32;
+			auto Sin(oxyF32 x) -> oxyF32;
+			auto Cos(oxyF32 x) -> oxyF32;
+			auto Tan(oxyF32 x) -> oxyF32;
+			auto Asin(oxyF32 x) -> oxyF32;
+			auto Acos(oxyF32 x) -> oxyF32;
+			auto Atan(oxyF32 x) -> oxyF32;
+			auto Atan2(oxyF32 y, oxyF32 x) -> oxyF32;
+		}; // namespace Deterministic
+	}; // namespace Math
+}; // namespace oxygen
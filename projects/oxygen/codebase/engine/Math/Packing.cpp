@@ -0,0 +1,475 @@
+#include "OxygenPCH.h"
+#include "Math/Packing.h"
+
+#include <cstring>
+
+#include "Platform/CpuFeatures.h"
+
+// Like the batch kernels these are compiled for every x86 build and selected
+// at run time. They give the same bits as the scalar versions and use no FMA,
+// so unlike the batch kernels they stay enabled in deterministic builds.
+#ifdef OXYMATHSSE
+#define OXYMATHPACKINGAVX2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define OXYTARGETAVX2
+#define OXYTARGETF16C
+#else
+#define OXYTARGETAVX2 __attribute__((target("avx2")))
+#define OXYTARGETF16C __attribute__((target("avx,f16c")))
+#endif
+#endif
+
+namespace oxygen
+{
+	namespace Math
+	{
+		namespace
+		{
+			template <typename In, typename Out>
+			using ConvertKernel = auto (*)(const In*, Out*, oxySize, oxySize)
+				-> void;
+			using OctEncodeKernel = auto (*)(Vec3Streams<const oxyF32>,
+											 oxyF32*, oxySize, oxySize)
+				-> void;
+
+			struct PackingKernels
+			{
+				ConvertKernel<oxyF32, oxyU16> m_toHalf{};
+				ConvertKernel<oxyU16, oxyF32> m_fromHalf{};
+				ConvertKernel<oxyF32, oxyU8> m_toUnorm8{};
+				ConvertKernel<oxyF32, oxyU16> m_toUnorm16{};
+				ConvertKernel<oxyF32, oxyS8> m_toSnorm8{};
+				ConvertKernel<oxyF32, oxyS16> m_toSnorm16{};
+				OctEncodeKernel m_octEncode{};
+			};
+
+			/**
+			 * @brief Converts [begin, end). Also finishes the remainder of
+			 * the wide kernels.
+			 */
+			template <typename In, typename Out, auto Convert>
+			auto ConvertScalar(const In* in, Out* out, oxySize begin,
+							   oxySize end) -> void
+			{
+				for (oxySize i = begin; i < end; i++)
+					out[i] = Convert(in[i]);
+			}
+
+			auto OctEncodeScalar(Vec3Streams<const oxyF32> in, oxyF32* out,
+								 oxySize begin, oxySize end) -> void
+			{
+				for (oxySize i = begin; i < end; i++)
+				{
+					const auto e = OctEncode({in.m_x[i], in.m_y[i], in.m_z[i]});
+					out[2 * i] = e.x;
+					out[2 * i + 1] = e.y;
+				}
+			}
+
+#ifdef OXYMATHPACKINGAVX2
+			OXYTARGETF16C auto FloatToHalfF16C(const oxyF32* in, oxyU16* out,
+											   oxySize begin, oxySize end)
+				-> void
+			{
+				auto i = begin;
+				for (; i + 8 <= end; i += 8)
+				{
+					const auto h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i),
+												   _MM_FROUND_TO_NEAREST_INT);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+				}
+				_mm256_zeroupper();
+				ConvertScalar<oxyF32, oxyU16, &FloatToHalf>(in, out, i, end);
+			}
+
+			OXYTARGETF16C auto HalfToFloatF16C(const oxyU16* in, oxyF32* out,
+											   oxySize begin, oxySize end)
+				-> void
+			{
+				auto i = begin;
+				for (; i + 8 <= end; i += 8)
+				{
+					const auto h = _mm_loadu_si128(
+						reinterpret_cast<const __m128i*>(in + i));
+					_mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+				}
+				_mm256_zeroupper();
+				ConvertScalar<oxyU16, oxyF32, &HalfToFloat>(in, out, i, end);
+			}
+
+			/**
+			 * @brief Eight clamped and scaled values rounded to integers,
+			 * split into the low and high four.
+			 */
+			template <oxyBool Signed, typename T>
+			OXYTARGETAVX2 inline auto QuantizeAvx2(const oxyF32* in,
+												   __m128i& lo, __m128i& hi)
+				-> void
+			{
+				constexpr auto max =
+					static_cast<oxyF32>(std::numeric_limits<T>::max());
+				auto v = _mm256_loadu_ps(in);
+				if constexpr (Signed)
+				{
+					// NaN to 0 first, the clamp below keeps NaN as -1
+					v = _mm256_and_ps(v, _mm256_cmp_ps(v, v, _CMP_ORD_Q));
+					v = _mm256_max_ps(v, _mm256_set1_ps(-1.0f));
+				}
+				else
+				{
+					v = _mm256_max_ps(v, _mm256_setzero_ps());
+				}
+				v = _mm256_min_ps(v, _mm256_set1_ps(1.0f));
+				const auto i = _mm256_cvtps_epi32(
+					_mm256_mul_ps(v, _mm256_set1_ps(max)));
+				lo = _mm256_castsi256_si128(i);
+				hi = _mm256_extracti128_si256(i, 1);
+			}
+
+			template <oxyBool Signed, typename T>
+			OXYTARGETAVX2 auto QuantizeAvx2Kernel(const oxyF32* in, T* out,
+												  oxySize begin, oxySize end)
+				-> void
+			{
+				auto i = begin;
+				for (; i + 8 <= end; i += 8)
+				{
+					__m128i lo, hi;
+					QuantizeAvx2<Signed, T>(in + i, lo, hi);
+					// The values are in range, saturation changes nothing
+					const auto words = Signed ? _mm_packs_epi32(lo, hi)
+											  : _mm_packus_epi32(lo, hi);
+					auto* dst = reinterpret_cast<__m128i*>(out + i);
+					if constexpr (sizeof(T) == 2)
+						_mm_storeu_si128(dst, words);
+					else if constexpr (Signed)
+						_mm_storel_epi64(dst, _mm_packs_epi16(words, words));
+					else
+						_mm_storel_epi64(dst, _mm_packus_epi16(words, words));
+				}
+				_mm256_zeroupper();
+				if constexpr (Signed)
+					ConvertScalar<oxyF32, T, &FloatToSnorm<T>>(in, out, i, end);
+				else
+					ConvertScalar<oxyF32, T, &FloatToUnorm<T>>(in, out, i, end);
+			}
+
+			OXYTARGETAVX2 auto OctEncodeAvx2(Vec3Streams<const oxyF32> in,
+											 oxyF32* out, oxySize begin,
+											 oxySize end) -> void
+			{
+				const auto zero = _mm256_setzero_ps();
+				const auto one = _mm256_set1_ps(1.0f);
+				const auto minusOne = _mm256_set1_ps(-1.0f);
+				const auto signMask = _mm256_set1_ps(-0.0f);
+				auto i = begin;
+				for (; i + 8 <= end; i += 8)
+				{
+					const auto x = _mm256_loadu_ps(in.m_x + i);
+					const auto y = _mm256_loadu_ps(in.m_y + i);
+					const auto z = _mm256_loadu_ps(in.m_z + i);
+					const auto ax = _mm256_andnot_ps(signMask, x);
+					const auto ay = _mm256_andnot_ps(signMask, y);
+					const auto az = _mm256_andnot_ps(signMask, z);
+					const auto l1 = _mm256_add_ps(_mm256_add_ps(ax, ay), az);
+					auto ex = _mm256_div_ps(x, l1);
+					auto ey = _mm256_div_ps(y, l1);
+
+					// Lower hemisphere folded over the diagonals
+					const auto sx = _mm256_blendv_ps(
+						minusOne, one, _mm256_cmp_ps(ex, zero, _CMP_GE_OQ));
+					const auto sy = _mm256_blendv_ps(
+						minusOne, one, _mm256_cmp_ps(ey, zero, _CMP_GE_OQ));
+					const auto fx = _mm256_mul_ps(
+						_mm256_sub_ps(one, _mm256_andnot_ps(signMask, ey)), sx);
+					const auto fy = _mm256_mul_ps(
+						_mm256_sub_ps(one, _mm256_andnot_ps(signMask, ex)), sy);
+					const auto lower = _mm256_cmp_ps(z, zero, _CMP_LT_OQ);
+					ex = _mm256_blendv_ps(ex, fx, lower);
+					ey = _mm256_blendv_ps(ey, fy, lower);
+
+					// Zero and NaN lengths give 0
+					const auto valid = _mm256_cmp_ps(l1, zero, _CMP_GT_OQ);
+					ex = _mm256_and_ps(ex, valid);
+					ey = _mm256_and_ps(ey, valid);
+
+					const auto lo = _mm256_unpacklo_ps(ex, ey);
+					const auto hi = _mm256_unpackhi_ps(ex, ey);
+					_mm256_storeu_ps(out + 2 * i,
+									 _mm256_permute2f128_ps(lo, hi, 0x20));
+					_mm256_storeu_ps(out + 2 * i + 8,
+									 _mm256_permute2f128_ps(lo, hi, 0x31));
+				}
+				_mm256_zeroupper();
+				OctEncodeScalar(in, out, i, end);
+			}
+#endif
+
+			auto SelectKernels() -> PackingKernels
+			{
+				PackingKernels kernels{
+					&ConvertScalar<oxyF32, oxyU16, &FloatToHalf>,
+					&ConvertScalar<oxyU16, oxyF32, &HalfToFloat>,
+					&ConvertScalar<oxyF32, oxyU8, &FloatToUnorm<oxyU8>>,
+					&ConvertScalar<oxyF32, oxyU16, &FloatToUnorm<oxyU16>>,
+					&ConvertScalar<oxyF32, oxyS8, &FloatToSnorm<oxyS8>>,
+					&ConvertScalar<oxyF32, oxyS16, &FloatToSnorm<oxyS16>>,
+					&OctEncodeScalar};
+#ifdef OXYMATHPACKINGAVX2
+				const auto& cpu = GetCpuFeatures();
+				if (cpu.m_f16c)
+				{
+					kernels.m_toHalf = &FloatToHalfF16C;
+					kernels.m_fromHalf = &HalfToFloatF16C;
+				}
+				if (cpu.m_avx2)
+				{
+					kernels.m_toUnorm8 = &QuantizeAvx2Kernel<false, oxyU8>;
+					kernels.m_toUnorm16 = &QuantizeAvx2Kernel<false, oxyU16>;
+					kernels.m_toSnorm8 = &QuantizeAvx2Kernel<true, oxyS8>;
+					kernels.m_toSnorm16 = &QuantizeAvx2Kernel<true, oxyS16>;
+					kernels.m_octEncode = &OctEncodeAvx2;
+				}
+#endif
+				return kernels;
+			}
+
+			auto GetKernels() -> const PackingKernels&
+			{
+				static const PackingKernels kernels = SelectKernels();
+				return kernels;
+			}
+
+			enum class VertexEncoding : oxyU8
+			{
+				Float32,
+				Float16,
+				Unorm8,
+				Unorm16,
+				Snorm8,
+				Snorm16,
+			};
+
+			struct VertexFormatInfo
+			{
+				VertexEncoding m_encoding{};
+				oxyU8 m_components{};
+				oxyU8 m_componentSize{};
+			};
+
+			auto GetVertexFormatInfo(GfxFormat format, VertexFormatInfo& info)
+				-> oxyBool
+			{
+				switch (format)
+				{
+#define CASEVERTEXFORMAT(x, encoding, components, size)                        \
+	case GfxFormat_##x:                                                        \
+		info = {VertexEncoding::encoding, components, size};                   \
+		return true;
+					CASEVERTEXFORMAT(R8, Unorm8, 1, 1);
+					CASEVERTEXFORMAT(R8S, Snorm8, 1, 1);
+					CASEVERTEXFORMAT(R16, Unorm16, 1, 2);
+					CASEVERTEXFORMAT(R16F, Float16, 1, 2);
+					CASEVERTEXFORMAT(R16S, Snorm16, 1, 2);
+					CASEVERTEXFORMAT(R32F, Float32, 1, 4);
+					CASEVERTEXFORMAT(RG8, Unorm8, 2, 1);
+					CASEVERTEXFORMAT(RG8S, Snorm8, 2, 1);
+					CASEVERTEXFORMAT(RG16, Unorm16, 2, 2);
+					CASEVERTEXFORMAT(RG16F, Float16, 2, 2);
+					CASEVERTEXFORMAT(RG16S, Snorm16, 2, 2);
+					CASEVERTEXFORMAT(RG32F, Float32, 2, 4);
+					CASEVERTEXFORMAT(RGB8, Unorm8, 3, 1);
+					CASEVERTEXFORMAT(RGB8S, Snorm8, 3, 1);
+					CASEVERTEXFORMAT(RGB16, Unorm16, 3, 2);
+					CASEVERTEXFORMAT(RGB16F, Float16, 3, 2);
+					CASEVERTEXFORMAT(RGB16S, Snorm16, 3, 2);
+					CASEVERTEXFORMAT(RGB32F, Float32, 3, 4);
+					CASEVERTEXFORMAT(RGBA8, Unorm8, 4, 1);
+					CASEVERTEXFORMAT(RGBA8S, Snorm8, 4, 1);
+					CASEVERTEXFORMAT(RGBA16, Unorm16, 4, 2);
+					CASEVERTEXFORMAT(RGBA16F, Float16, 4, 2);
+					CASEVERTEXFORMAT(RGBA16S, Snorm16, 4, 2);
+					CASEVERTEXFORMAT(RGBA32F, Float32, 4, 4);
+#undef CASEVERTEXFORMAT
+				default:
+					break;
+				}
+				return false;
+			}
+
+			auto Convert(VertexEncoding encoding, const oxyF32* in, oxyU8* out,
+						 oxySize count) -> void
+			{
+				const auto& kernels = GetKernels();
+				switch (encoding)
+				{
+				case VertexEncoding::Float32:
+					std::memcpy(out, in, count * sizeof(oxyF32));
+					break;
+				case VertexEncoding::Float16:
+					kernels.m_toHalf(in, reinterpret_cast<oxyU16*>(out), 0,
+									 count);
+					break;
+				case VertexEncoding::Unorm8:
+					kernels.m_toUnorm8(in, out, 0, count);
+					break;
+				case VertexEncoding::Unorm16:
+					kernels.m_toUnorm16(in, reinterpret_cast<oxyU16*>(out), 0,
+										count);
+					break;
+				case VertexEncoding::Snorm8:
+					kernels.m_toSnorm8(in, reinterpret_cast<oxyS8*>(out), 0,
+									   count);
+					break;
+				case VertexEncoding::Snorm16:
+					kernels.m_toSnorm16(in, reinterpret_cast<oxyS16*>(out), 0,
+										count);
+					break;
+				}
+			}
+		}; // namespace
+
+		auto FloatToHalfBatch(const oxyF32* in, oxyU16* out, oxySize count)
+			-> void
+		{
+			GetKernels().m_toHalf(in, out, 0, count);
+		}
+
+		auto HalfToFloatBatch(const oxyU16* in, oxyF32* out, oxySize count)
+			-> void
+		{
+			GetKernels().m_fromHalf(in, out, 0, count);
+		}
+
+		auto FloatToUnorm8Batch(const oxyF32* in, oxyU8* out, oxySize count)
+			-> void
+		{
+			GetKernels().m_toUnorm8(in, out, 0, count);
+		}
+
+		auto FloatToUnorm16Batch(const oxyF32* in, oxyU16* out,
+								 oxySize count) -> void
+		{
+			GetKernels().m_toUnorm16(in, out, 0, count);
+		}
+
+		auto FloatToSnorm8Batch(const oxyF32* in, oxyS8* out, oxySize count)
+			-> void
+		{
+			GetKernels().m_toSnorm8(in, out, 0, count);
+		}
+
+		auto FloatToSnorm16Batch(const oxyF32* in, oxyS16* out,
+								 oxySize count) -> void
+		{
+			GetKernels().m_toSnorm16(in, out, 0, count);
+		}
+
+		auto OctEncodeBatch(Vec3Streams<const oxyF32> in, oxyF32* out,
+							oxySize count) -> void
+		{
+			GetKernels().m_octEncode(in, out, 0, count);
+		}
+
+		auto GetPackedVertexFormatSize(GfxFormat format) -> oxySize
+		{
+			VertexFormatInfo info{};
+			if (!GetVertexFormatInfo(format, info))
+				return 0;
+			return oxySize{info.m_components} * info.m_componentSize;
+		}
+
+		auto PackVertices(std::span<const GfxVertexElement> elements,
+						  std::span<const VertexAttributeSource> sources,
+						  oxySize count, oxySize stride, oxyU8* out)
+			-> oxyBool
+		{
+			if (elements.size() != sources.size())
+				return false;
+			for (const auto& element : elements)
+			{
+				const auto size = GetPackedVertexFormatSize(element.m_format);
+				if (size == 0 || element.m_offset + size > stride)
+					return false;
+			}
+
+			// Vertices are converted a chunk at a time, each element into a
+			// staging area first, so the kernels see contiguous streams
+			constexpr oxySize k_chunk = 256;
+			alignas(32) oxyF32 staging[k_chunk * 4];
+			alignas(32) oxyF32 encoded[k_chunk * 2];
+			alignas(32) oxyU8 packed[k_chunk * 4 * sizeof(oxyF32)];
+			for (oxySize begin = 0; begin < count; begin += k_chunk)
+			{
+				const auto n = std::min(k_chunk, count - begin);
+				for (oxySize e = 0; e < elements.size(); e++)
+				{
+					const auto& element = elements[e];
+					const auto& source = sources[e];
+					VertexFormatInfo info{};
+					GetVertexFormatInfo(element.m_format, info);
+					const auto sourceStride =
+						source.m_stride
+							? source.m_stride
+							: oxySize{source.m_components} * sizeof(oxyF32);
+					const auto* base =
+						reinterpret_cast<const oxyU8*>(source.m_data) +
+						begin * sourceStride;
+					const auto vertex = [&](oxySize v) {
+						return reinterpret_cast<const oxyF32*>(
+							base + v * sourceStride);
+					};
+
+					const auto* values = staging;
+					if (element.m_semantic == GfxVertexElementSemantic_Normal &&
+						info.m_components == 2 && source.m_components == 3)
+					{
+						auto* x = staging;
+						auto* y = staging + k_chunk;
+						auto* z = staging + 2 * k_chunk;
+						for (oxySize v = 0; v < n; v++)
+						{
+							const auto* p = vertex(v);
+							x[v] = p[0];
+							y[v] = p[1];
+							z[v] = p[2];
+						}
+						GetKernels().m_octEncode({x, y, z}, encoded, 0, n);
+						// UNORM can not hold the [-1, 1] encoding, store it
+						// as e * 0.5 + 0.5 for the shader to expand
+						if (info.m_encoding == VertexEncoding::Unorm8 ||
+							info.m_encoding == VertexEncoding::Unorm16)
+						{
+							for (oxySize i = 0; i < 2 * n; i++)
+								encoded[i] = encoded[i] * 0.5f + 0.5f;
+						}
+						values = encoded;
+					}
+					else
+					{
+						const auto components = info.m_components;
+						for (oxySize v = 0; v < n; v++)
+						{
+							const auto* p = vertex(v);
+							for (oxySize c = 0; c < components; c++)
+							{
+								staging[v * components + c] =
+									c < source.m_components ? p[c] : 0.0f;
+							}
+						}
+					}
+
+					Convert(info.m_encoding, values, packed,
+							n * info.m_components);
+					const oxySize size =
+						oxySize{info.m_components} * info.m_componentSize;
+					auto* dst = out + begin * stride + element.m_offset;
+					for (oxySize v = 0; v < n; v++)
+						std::memcpy(dst + v * stride, packed + v * size, size);
+				}
+			}
+			return true;
+		}
+	}; // namespace Math
+}; // namespace oxygen
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "Math/Batch.h"
+
+namespace oxygen
+{
+	namespace Math
+	{
+		/**
+		 * @brief Rounds to the nearest integer, ties to even, like the SIMD
+		 * conversions in the default rounding mode. |v| must be below 2^31.
+		 */
+		constexpr auto RoundToEven(oxyF32 v) -> oxyS32
+		{
+			auto i = static_cast<oxyS32>(v);
+			const auto frac = v - static_cast<oxyF32>(i);
+			if (frac > 0.5f || (frac == 0.5f && (i & 1)))
+				i++;
+			else if (frac < -0.5f || (frac == -0.5f && (i & 1)))
+				i--;
+			return i;
+		}
+
+		/**
+		 * @brief IEEE 754 binary16 nearest to f, ties to even. Values past
+		 * the half range become infinity and NaNs stay quiet NaNs, so the
+		 * result has the same bits as the F16C instruction.
+		 */
+		constexpr auto FloatToHalf(oxyF32 f) -> oxyU16
+		{
+			const auto bits = std::bit_cast<oxyU32>(f);
+			const auto sign = static_cast<oxyU16>((bits >> 16) & 0x8000);
+			const auto magnitude = bits & 0x7fffffff;
+			if (magnitude > 0x7f800000)
+			{
+				const auto payload = (magnitude >> 13) & 0x3ff;
+				return static_cast<oxyU16>(sign | 0x7e00 | payload);
+			}
+			// 65520 and up round past the largest half, 65504
+			if (magnitude >= 0x477ff000)
+				return static_cast<oxyU16>(sign | 0x7c00);
+			if (magnitude >= 0x38800000)
+			{
+				// Rebias the exponent from 127 to 15, then round away the
+				// low 13 mantissa bits. A carry moves into the exponent.
+				const auto m = magnitude - 0x38000000;
+				const auto rounded = m + 0xfff + ((m >> 13) & 1);
+				return static_cast<oxyU16>(sign | (rounded >> 13));
+			}
+			// Half of the smallest subnormal, 2^-25, and below round to zero
+			if (magnitude <= 0x33000000)
+				return sign;
+			const auto mantissa = (magnitude & 0x7fffff) | 0x800000;
+			const auto shift = 126 - (magnitude >> 23);
+			const auto halfway = oxyU32{1} << (shift - 1);
+			const auto rest = mantissa & ((oxyU32{1} << shift) - 1);
+			auto result = mantissa >> shift;
+			if (rest > halfway || (rest == halfway && (result & 1)))
+				result++;
+			return static_cast<oxyU16>(sign | result);
+		}
+		/**
+		 * @brief Exact, every half is representable as a float. Signaling
+		 * NaNs become quiet, as with F16C.
+		 */
+		constexpr auto HalfToFloat(oxyU16 h) -> oxyF32
+		{
+			const auto sign = static_cast<oxyU32>(h & 0x8000) << 16;
+			const auto exponent = static_cast<oxyU32>(h >> 10) & 0x1f;
+			auto mantissa = static_cast<oxyU32>(h & 0x3ff);
+			if (exponent == 0x1f)
+			{
+				const auto quiet = mantissa ? 0x400000u : 0u;
+				return std::bit_cast<oxyF32>(sign | 0x7f800000 | quiet |
+											 (mantissa << 13));
+			}
+			if (exponent != 0)
+				return std::bit_cast<oxyF32>(sign | ((exponent + 112) << 23) |
+											 (mantissa << 13));
+			if (mantissa == 0)
+				return std::bit_cast<oxyF32>(sign);
+			// Subnormal, normalize it
+			oxyU32 e = 113;
+			while (!(mantissa & 0x400))
+			{
+				mantissa <<= 1;
+				e--;
+			}
+			return std::bit_cast<oxyF32>(sign | (e << 23) |
+										 ((mantissa & 0x3ff) << 13));
+		}
+
+		/**
+		 * @brief v clamped to [0, 1] and scaled to [0, max], ties to even.
+		 * NaN becomes 0. These follow the Direct3D conversion rules.
+		 */
+		template <typename T> constexpr auto FloatToUnorm(oxyF32 v) -> T
+		{
+			constexpr auto max =
+				static_cast<oxyF32>(std::numeric_limits<T>::max());
+			v = v > 0.0f ? v : 0.0f;
+			v = v < 1.0f ? v : 1.0f;
+			return static_cast<T>(RoundToEven(v * max));
+		}
+		/**
+		 * @brief v clamped to [-1, 1] and scaled to [-max, max], ties to
+		 * even. NaN becomes 0, the most negative integer is never produced.
+		 */
+		template <typename T> constexpr auto FloatToSnorm(oxyF32 v) -> T
+		{
+			constexpr auto max =
+				static_cast<oxyF32>(std::numeric_limits<T>::max());
+			v = v > -1.0f ? v : (v == v ? -1.0f : 0.0f);
+			v = v < 1.0f ? v : 1.0f;
+			return static_cast<T>(RoundToEven(v * max));
+		}
+		template <typename T> constexpr auto UnormToFloat(T v) -> oxyF32
+		{
+			constexpr auto max =
+				static_cast<oxyF32>(std::numeric_limits<T>::max());
+			return static_cast<oxyF32>(v) / max;
+		}
+		template <typename T> constexpr auto SnormToFloat(T v) -> oxyF32
+		{
+			constexpr auto max =
+				static_cast<oxyF32>(std::numeric_limits<T>::max());
+			const auto f = static_cast<oxyF32>(v) / max;
+			return f > -1.0f ? f : -1.0f;
+		}
+
+		/**
+		 * @brief Maps a unit vector to the [-1, 1] square by projecting it
+		 * on the octahedron |x| + |y| + |z| = 1 and folding the lower half
+		 * over the diagonals. Stored as two SNORM16 values the angular
+		 * error stays below 0.05 degrees. A zero vector maps to 0.
+		 */
+		inline auto OctEncode(const oxyVec3& n) -> oxyVec2
+		{
+			const auto l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+			if (!(l1 > 0.0f))
+				return {};
+			auto x = n.x / l1;
+			auto y = n.y / l1;
+			if (n.z < 0.0f)
+			{
+				const auto fx = (1.0f - std::fabs(y)) * (x >= 0 ? 1.0f : -1.0f);
+				const auto fy = (1.0f - std::fabs(x)) * (y >= 0 ? 1.0f : -1.0f);
+				x = fx;
+				y = fy;
+			}
+			return {x, y};
+		}
+		inline auto OctDecode(const oxyVec2& e) -> oxyVec3
+		{
+			oxyVec3 n{e.x, e.y, 1.0f - std::fabs(e.x) - std::fabs(e.y)};
+			const auto t = n.z < 0.0f ? -n.z : 0.0f;
+			n.x += n.x >= 0.0f ? -t : t;
+			n.y += n.y >= 0.0f ? -t : t;
+			return n.SafeNormalized();
+		}
+
+		/**
+		 * @brief out[i] = FloatToHalf(in[i]). F16C is used when the CPU
+		 * has it.
+		 */
+		auto FloatToHalfBatch(const oxyF32* in, oxyU16* out, oxySize count)
+			-> void;
+		auto HalfToFloatBatch(const oxyU16* in, oxyF32* out, oxySize count)
+			-> void;
+		auto FloatToUnorm8Batch(const oxyF32* in, oxyU8* out, oxySize count)
+			-> void;
+		auto FloatToUnorm16Batch(const oxyF32* in, oxyU16* out,
+								 oxySize count) -> void;
+		auto FloatToSnorm8Batch(const oxyF32* in, oxyS8* out, oxySize count)
+			-> void;
+		auto FloatToSnorm16Batch(const oxyF32* in, oxyS16* out,
+								 oxySize count) -> void;
+		/**
+		 * @brief out[2 * i] and out[2 * i + 1] = OctEncode(in[i]).
+		 */
+		auto OctEncodeBatch(Vec3Streams<const oxyF32> in, oxyF32* out,
+							oxySize count) -> void;
+
+		/**
+		 * @brief Float data of one vertex element.
+		 */
+		struct VertexAttributeSource
+		{
+			const oxyF32* m_data{};
+			// Floats used per vertex. Missing components are written as 0,
+			// extra ones are ignored.
+			oxyU8 m_components{};
+			// Bytes from one vertex to the next, 0 for m_components floats
+			oxySize m_stride{};
+		};
+
+		/**
+		 * @brief Bytes one element of the format takes in a vertex.
+		 * @return 0 if PackVertices can not produce the format
+		 */
+		auto GetPackedVertexFormatSize(GfxFormat format) -> oxySize;
+
+		/**
+		 * @brief Interleaves count vertices into out, element i taken from
+		 * sources[i] and written at its m_offset, vertices stride bytes
+		 * apart. Float formats are stored as 32 or 16 bit floats, the
+		 * others as UNORM (no suffix) or SNORM (S suffix) integers. A
+		 * normal stored in a two component format from a three component
+		 * source is octahedral encoded, see OctEncode. The UNORM formats
+		 * RG8 and RG16 store it remapped as e * 0.5 + 0.5, shaders expand
+		 * it with value * 2 - 1 before OctDecode. The SNORM and float
+		 * formats store it as is.
+		 * @return False, writing nothing, if a format is not supported or
+		 * an element does not fit in stride
+		 */
+		auto PackVertices(std::span<const GfxVertexElement> elements,
+						  std::span<const VertexAttributeSource> sources,
+						  oxySize count, oxySize stride, oxyU8* out)
+			-> oxyBool;
+	}; // namespace Math
+}; // namespace oxygen
@@ -0,0 +1,557 @@
+#pragma once
+
+// Instruction set selection, compile time only. Define OXYMATHSCALAR to force
+// the portable path.
+//
+// Define OXYMATHDETERMINISTIC for bit identical results across compilers and
+// machines, e.g. for lockstep simulation and replays. It disables fused
+// multiply-add, the rsqrt estimate and the runtime selected AVX2 kernels, and
+// routes the Math helpers to Math::Deterministic. It needs a precise floating
+// point model without contraction (/fp:precise, -ffp-contract=off).
+#if defined(OXYMATHDETERMINISTIC) &&                                           \
+	(defined(_M_FP_FAST) || defined(__FAST_MATH__))
+#error "OXYMATHDETERMINISTIC needs a precise floating point model"
+#endif
+#ifndef OXYMATHSCALAR
+#if defined(_M_X64) || defined(__SSE2__) ||                                    \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OXYMATHSSE
+#include <emmintrin.h>
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define OXYMATHSSE41
+#include <smmintrin.h>
+#endif
+#if defined(__AVX__)
+#define OXYMATHAVX
+#include <immintrin.h>
+#endif
+#if (defined(__FMA__) || defined(__AVX2__)) && !defined(OXYMATHDETERMINISTIC)
+#define OXYMATHFMA
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define OXYMATHNEON
+#ifndef OXYMATHDETERMINISTIC
+#define OXYMATHFMA
+#endif
+#include <arm_neon.h>
+#else
+#define OXYMATHSCALAR
+#endif
+#endif
+
+namespace oxygen
+{
+	namespace Math
+	{
+		/**
+		 * @brief Precision of reciprocal square roots and normalization.
+		 * Exact divides by a correctly rounded square root. Fast refines the
+		 * hardware estimate with one Newton step, within a few ulp and
+		 * several times cheaper.
+		 */
+		enum class Accuracy : oxyU8
+		{
+			Exact,
+			Fast,
+		};
+
+		// Define OXYMATHFASTRSQRT to make Fast the default of Normalized
+#ifdef OXYMATHFASTRSQRT
+		static inline constexpr auto k_defaultAccuracy = Accuracy::Fast;
+#else
+		static inline constexpr auto k_defaultAccuracy = Accuracy::Exact;
+#endif
+
+		/**
+		 * @brief Smallest squared length the safe normalizations accept,
+		 * shorter vectors have no reliable direction.
+		 */
+		static inline constexpr auto k_minLengthSquared =
+			std::numeric_limits<oxyF32>::min();
+
+		/**
+		 * @brief Thin wrappers over 4-wide float registers so the math types
+		 * are written once for SSE, NEON and the scalar fallback. Load and
+		 * Store require 16 byte alignment.
+		 */
+		namespace Simd
+		{
+#if defined(OXYMATHAVX)
+			static inline constexpr std::string_view k_backendName = "avx";
+#elif defined(OXYMATHSSE41)
+			static inline constexpr std::string_view k_backendName = "sse41";
+#elif defined(OXYMATHSSE)
+			static inline constexpr std::string_view k_backendName = "sse2";
+#elif defined(OXYMATHNEON)
+			static inline constexpr std::string_view k_backendName = "neon";
+#else
+			static inline constexpr std::string_view k_backendName = "scalar";
+#endif
+
+#if defined(OXYMATHSSE)
+			using Float4 = __m128;
+#elif defined(OXYMATHNEON)
+			using Float4 = float32x4_t;
+#else
+			struct Float4
+			{
+				oxyF32 v[4];
+			};
+#endif
+
+			inline auto Load(const oxyF32* p) -> Float4
+			{
+#if defined(OXYMATHSSE)
+				return _mm_load_ps(p);
+#elif defined(OXYMATHNEON)
+				return vld1q_f32(p);
+#else
+				return {p[0], p[1], p[2], p[3]};
+#endif
+			}
+			inline auto Store(oxyF32* p, Float4 a) -> void
+			{
+#if defined(OXYMATHSSE)
+				_mm_store_ps(p, a);
+#elif defined(OXYMATHNEON)
+				vst1q_f32(p, a);
+#else
+				p[0] = a.v[0];
+				p[1] = a.v[1];
+				p[2] = a.v[2];
+				p[3] = a.v[3];
+#endif
+			}
+			inline auto Set(oxyF32 x, oxyF32 y, oxyF32 z, oxyF32 w) -> Float4
+			{
+#if defined(OXYMATHSSE)
+				return _mm_setr_ps(x, y, z, w);
+#elif defined(OXYMATHNEON)
+				const oxyF32 lanes[4]{x, y, z, w};
+				return vld1q_f32(lanes);
+#else
+				return {x, y, z, w};
+#endif
+			}
+			inline auto Splat(oxyF32 x) -> Float4
+			{
+#if defined(OXYMATHSSE)
+				return _mm_set1_ps(x);
+#elif defined(OXYMATHNEON)
+				return vdupq_n_f32(x);
+#else
+				return {x, x, x, x};
+#endif
+			}
+			inline auto GetX(Float4 a) -> oxyF32
+			{
+#if defined(OXYMATHSSE)
+				return _mm_cvtss_f32(a);
+#elif defined(OXYMATHNEON)
+				return vgetq_lane_f32(a, 0);
+#else
+				return a.v[0];
+#endif
+			}
+
+			/**
+			 * @brief Result lane i is lane I[i] of a.
+			 */
+			template <int X, int Y, int Z, int W>
+			inline auto Permute(Float4 a) -> Float4
+			{
+#if defined(OXYMATHSSE)
+				return _mm_shuffle_ps(a, a, _MM_SHUFFLE(W, Z, Y, X));
+#elif defined(OXYMATHNEON)
+				auto result = vdupq_n_f32(vgetq_lane_f32(a, X));
+				result = vsetq_lane_f32(vgetq_lane_f32(a, Y), result, 1);
+				result = vsetq_lane_f32(vgetq_lane_f32(a, Z), result, 2);
+				return vsetq_lane_f32(vgetq_lane_f32(a, W), result, 3);
+#else
+				return {a.v[X], a.v[Y], a.v[Z], a.v[W]};
+#endif
+			}
+			/**
+			 * @brief Lanes 0 and 1 come from a, lanes 2 and 3 from b.
+			 */
+			template <int X, int Y, int Z, int W>
+			inline auto Shuffle(Float4 a, Float4 b) -> Float4
+			{
+#if defined(OXYMATHSSE)
+				return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+#elif defined(OXYMATHNEON)
+				auto result = vdupq_n_f32(vgetq_lane_f32(a, X));
+				result = vsetq_lane_f32(vgetq_lane_f32(a, Y), result, 1);
+				result = vsetq_lane_f32(vgetq_lane_f32(b, Z), result, 2);
+				return vsetq_lane_f32(vgetq_lane_f32(b, W), result, 3);
+#else
+				return {a.v[X], a.v[Y], b.v[Z], b.v[W]};
+#endif
+			}
+			template <int I> inline auto SplatLane(Float4 a) -> Float4
+			{
+#if defined(OXYMATHNEON)
+				return vdupq_laneq_f32(a, I);
+#else
+				return Permute<I, I, I, I>(a);
+#endif
+			}
+
+			inline auto Add(Float4 a, Float4 b) -> Float4
+			{
+#if defined(OXYMATHSSE)
+				return _mm_add_ps(a, b);
+#elif defined(OXYMATHNEON)
+				return vaddq_f32(a, b);
+#else
+				return {a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2],
+						a.v[3] + b.v[3]};
+#endif
+			}
+			inline auto Sub(Float4 a, Float4 b) -> Float4
+			{
+#if defined(OXYMATHSSE)
+				return _mm_sub_ps(a, b);
+#elif defined(OXYMATHNEON)
+				return vsubq_f32(a, b);
+#else
+				return {a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2],
+						a.v[3] - b.v[3]};
+#endif
+			}
+			inline auto Mul(Float4 a, Float4 b) -> Float4
+			{
+#if defined(OXYMATHSSE)
+				return _mm_mul_ps(a, b);
+#elif defined(OXYMATHNEON)
+				return vmulq_f32(a, b);
+#else
+				return {a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2],
+						a.v[3] * b.v[3]};
+#endif
+			}
+			inline auto Div(Float4 a, Float4 b) -> Float4
+			{
+#if defined(OXYMATHSSE)
+				return _mm_div_ps(a, b);
+#elif defined(OXYMATHNEON)
+				return vdivq_f32(a, b);
+#else
+				return {a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2],
+						a.v[3] / b.v[3]};
+#endif
+			}
+			/**
+			 * @brief a * b + c, fused where the target supports it.
+			 */
+			inline auto MulAdd(Float4 a, Float4 b, Float4 c) -> Float4
+			{
+#if defined(OXYMATHSSE) && defined(OXYMATHFMA)
+				return _mm_fmadd_ps(a, b, c);
+#elif defined(OXYMATHNEON) && defined(OXYMATHFMA)
+				return vfmaq_f32(c, a, b);
+#else
+				return Add(Mul(a, b), c);
+#endif
+			}
+
+			inline auto Dot4(Float4 a, Float4 b) -> oxyF32
+			{
+#if defined(OXYMATHSSE41)
+				return _mm_cvtss_f32(_mm_dp_ps(a, b, 0xFF));
+#elif defined(OXYMATHSSE)
+				const auto m = _mm_mul_ps(a, b);
+				const auto s = _mm_add_ps(m, Permute<1, 0, 3, 2>(m));
+				return _mm_cvtss_f32(_mm_add_ss(s, Permute<2, 3, 0, 1>(s)));
+#elif defined(OXYMATHNEON)
+				return vaddvq_f32(vmulq_f32(a, b));
+#else
+				return (a.v[0] * b.v[0] + a.v[1] * b.v[1]) +
+					   (a.v[2] * b.v[2] + a.v[3] * b.v[3]);
+#endif
+			}
+
+			inline auto Dot3(Float4 a, Float4 b) -> oxyF32
+			{
+#if defined(OXYMATHSSE41)
+				return _mm_cvtss_f32(_mm_dp_ps(a, b, 0x7F));
+#else
+				const auto m = Mul(a, b);
+				return GetX(m) + GetX(SplatLane<1>(m)) + GetX(SplatLane<2>(m));
+#endif
+			}
+			inline auto Abs(Float4 a) -> Float4
+			{
+#if defined(OXYMATHSSE)
+				return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+#elif defined(OXYMATHNEON)
+				return vabsq_f32(a);
+#else
+				return {std::fabs(a.v[0]), std::fabs(a.v[1]), std::fabs(a.v[2]),
+						std::fabs(a.v[3])};
+#endif
+			}
+			inline auto Sqrt(Float4 a) -> Float4
+			{
+#if defined(OXYMATHSSE)
+				return _mm_sqrt_ps(a);
+#elif defined(OXYMATHNEON)
+				return vsqrtq_f32(a);
+#else
+				return {std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]),
+						std::sqrt(a.v[3])};
+#endif
+			}
+
+			/**
+			 * @brief Lanes set to all ones where a >= b, zero elsewhere
+			 * (including NaN lanes).
+			 */
+			inline auto CmpGe(Float4 a, Float4 b) -> Float4
+			{
+#if defined(OXYMATHSSE)
+				return _mm_cmpge_ps(a, b);
+#elif defined(OXYMATHNEON)
+				return vreinterpretq_f32_u32(vcgeq_f32(a, b));
+#else
+				Float4 result;
+				for (int i = 0; i < 4; i++)
+				{
+					result.v[i] = std::bit_cast<oxyF32>(
+						a.v[i] >= b.v[i] ? 0xFFFFFFFFu : 0u);
+				}
+				return result;
+#endif
+			}
+			/**
+			 * @brief Lanes of a where mask is set, of b elsewhere.
+			 */
+			inline auto Select(Float4 mask, Float4 a, Float4 b) -> Float4
+			{
+#if defined(OXYMATHSSE41)
+				return _mm_blendv_ps(b, a, mask);
+#elif defined(OXYMATHSSE)
+				return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+#elif defined(OXYMATHNEON)
+				return vbslq_f32(vreinterpretq_u32_f32(mask), a, b);
+#else
+				Float4 result;
+				for (int i = 0; i < 4; i++)
+				{
+					const auto m = std::bit_cast<oxyU32>(mask.v[i]);
+					result.v[i] = std::bit_cast<oxyF32>(
+						(std::bit_cast<oxyU32>(a.v[i]) & m) |
+						(std::bit_cast<oxyU32>(b.v[i]) & ~m));
+				}
+				return result;
+#endif
+			}
+
+			/**
+			 * @brief 1 / sqrt(a). Zero gives infinity for Exact and NaN for
+			 * Fast, see SafeRSqrt.
+			 */
+			template <Accuracy A> inline auto RSqrt(Float4 a) -> Float4
+			{
+				// Estimates differ between CPU vendors
+#ifndef OXYMATHDETERMINISTIC
+				if constexpr (A == Accuracy::Fast)
+				{
+#if defined(OXYMATHSSE)
+					// 12 bit estimate, e * (1.5 - 0.5 * a * e^2) doubles that
+					const auto e = _mm_rsqrt_ps(a);
+					const auto h =
+						_mm_mul_ps(_mm_mul_ps(a, _mm_set1_ps(0.5f)), e);
+					return _mm_mul_ps(
+						e, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(h, e)));
+#elif defined(OXYMATHNEON)
+					// The estimate has 8 bits, so two steps are needed
+					auto e = vrsqrteq_f32(a);
+					e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(a, e), e));
+					return vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(a, e), e));
+#endif
+				}
+#endif
+				return Div(Splat(1.0f), Sqrt(a));
+			}
+			/**
+			 * @brief RSqrt, or zero where a is below k_minLengthSquared or
+			 * NaN. No branches.
+			 */
+			template <Accuracy A> inline auto SafeRSqrt(Float4 a) -> Float4
+			{
+				return Select(CmpGe(a, Splat(k_minLengthSquared)), RSqrt<A>(a),
+							  Splat(0.0f));
+			}
+
+			/**
+			 * @brief Cross product of the xyz lanes, w is zero.
+			 */
+			inline auto Cross3(Float4 a, Float4 b) -> Float4
+			{
+				const auto t = Sub(Mul(a, Permute<1, 2, 0, 3>(b)),
+								   Mul(Permute<1, 2, 0, 3>(a), b));
+				return Permute<1, 2, 0, 3>(t);
+			}
+
+			inline auto Transpose(Float4& r0, Float4& r1, Float4& r2,
+								  Float4& r3) -> void
+			{
+#if defined(OXYMATHSSE)
+				_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+#elif defined(OXYMATHNEON)
+				const auto t0 = vzipq_f32(r0, r2);
+				const auto t1 = vzipq_f32(r1, r3);
+				const auto u0 = vzipq_f32(t0.val[0], t1.val[0]);
+				const auto u1 = vzipq_f32(t0.val[1], t1.val[1]);
+				r0 = u0.val[0];
+				r1 = u0.val[1];
+				r2 = u1.val[0];
+				r3 = u1.val[1];
+#else
+				Float4* rows[4]{&r0, &r1, &r2, &r3};
+				for (int i = 0; i < 4; i++)
+				{
+					for (int j = i + 1; j < 4; j++)
+						std::swap(rows[i]->v[j], rows[j]->v[i]);
+				}
+#endif
+			}
+
+			/**
+			 * @brief out = a * b for row major 4x4 matrices. out may alias a
+			 * or b.
+			 */
+			inline auto Multiply4x4(const oxyF32* a, const oxyF32* b,
+									oxyF32* out) -> void
+			{
+#if defined(OXYMATHAVX)
+				// Two result rows per iteration, one in each 128-bit half.
+				const auto b0 = _mm256_broadcast_ps(
+					reinterpret_cast<const __m128*>(b + 0));
+				const auto b1 = _mm256_broadcast_ps(
+					reinterpret_cast<const __m128*>(b + 4));
+				const auto b2 = _mm256_broadcast_ps(
+					reinterpret_cast<const __m128*>(b + 8));
+				const auto b3 = _mm256_broadcast_ps(
+					reinterpret_cast<const __m128*>(b + 12));
+				const auto a01 = _mm256_loadu_ps(a);
+				const auto a23 = _mm256_loadu_ps(a + 8);
+				const auto row = [&](__m256 ar) {
+					auto r = _mm256_mul_ps(_mm256_shuffle_ps(ar, ar, 0x00), b0);
+					r = _mm256_add_ps(
+						r, _mm256_mul_ps(_mm256_shuffle_ps(ar, ar, 0x55), b1));
+					r = _mm256_add_ps(
+						r, _mm256_mul_ps(_mm256_shuffle_ps(ar, ar, 0xAA), b2));
+					return _mm256_add_ps(
+						r, _mm256_mul_ps(_mm256_shuffle_ps(ar, ar, 0xFF), b3));
+				};
+				const auto r01 = row(a01);
+				const auto r23 = row(a23);
+				_mm256_storeu_ps(out, r01);
+				_mm256_storeu_ps(out + 8, r23);
+#elif defined(OXYMATHSCALAR)
+				oxyF32 result[16];
+				for (int i = 0; i < 4; i++)
+				{
+					for (int j = 0; j < 4; j++)
+					{
+						result[i * 4 + j] =
+							a[i * 4 + 0] * b[0 + j] + a[i * 4 + 1] * b[4 + j] +
+							a[i * 4 + 2] * b[8 + j] + a[i * 4 + 3] * b[12 + j];
+					}
+				}
+				std::copy_n(result, 16, out);
+#else
+				const auto b0 = Load(b + 0);
+				const auto b1 = Load(b + 4);
+				const auto b2 = Load(b + 8);
+				const auto b3 = Load(b + 12);
+				Float4 rows[4];
+				for (int i = 0; i < 4; i++)
+				{
+					const auto ar = Load(a + i * 4);
+					auto r = Mul(SplatLane<0>(ar), b0);
+					r = MulAdd(SplatLane<1>(ar), b1, r);
+					r = MulAdd(SplatLane<2>(ar), b2, r);
+					rows[i] = MulAdd(SplatLane<3>(ar), b3, r);
+				}
+				for (int i = 0; i < 4; i++)
+					Store(out + i * 4, rows[i]);
+#endif
+			}
+
+			// 2x2 blocks of a 4x4 matrix, stored as (m00, m01, m10, m11)
+			inline auto Mat2Mul(Float4 a, Float4 b) -> Float4
+			{
+				return MulAdd(Permute<1, 0, 3, 2>(a), Permute<2, 1, 2, 1>(b),
+							  Mul(a, Permute<0, 3, 0, 3>(b)));
+			}
+			// adj(a) * b
+			inline auto Mat2AdjMul(Float4 a, Float4 b) -> Float4
+			{
+				return Sub(Mul(Permute<3, 3, 0, 0>(a), b),
+						   Mul(Permute<1, 1, 2, 2>(a), Permute<2, 3, 0, 1>(b)));
+			}
+			// a * adj(b)
+			inline auto Mat2MulAdj(Float4 a, Float4 b) -> Float4
+			{
+				return Sub(Mul(a, Permute<3, 0, 3, 0>(b)),
+						   Mul(Permute<1, 0, 3, 2>(a), Permute<2, 1, 2, 1>(b)));
+			}
+
+			/**
+			 * @brief General 4x4 inverse by blockwise inversion of the 2x2
+			 * sub matrices. out may alias m. A singular m gives non-finite
+			 * values.
+			 * @return Determinant of m
+			 */
+			inline auto Inverse4x4(const oxyF32* m, oxyF32* out) -> oxyF32
+			{
+				const auto r0 = Load(m + 0);
+				const auto r1 = Load(m + 4);
+				const auto r2 = Load(m + 8);
+				const auto r3 = Load(m + 12);
+				const auto a = Shuffle<0, 1, 0, 1>(r0, r1);
+				const auto b = Shuffle<2, 3, 2, 3>(r0, r1);
+				const auto c = Shuffle<0, 1, 0, 1>(r2, r3);
+				const auto d = Shuffle<2, 3, 2, 3>(r2, r3);
+
+				// (|A|, |B|, |C|, |D|)
+				const auto subDets =
+					Sub(Mul(Shuffle<0, 2, 0, 2>(r0, r2),
+							Shuffle<1, 3, 1, 3>(r1, r3)),
+						Mul(Shuffle<1, 3, 1, 3>(r0, r2),
+							Shuffle<0, 2, 0, 2>(r1, r3)));
+				const auto detA = SplatLane<0>(subDets);
+				const auto detB = SplatLane<1>(subDets);
+				const auto detC = SplatLane<2>(subDets);
+				const auto detD = SplatLane<3>(subDets);
+
+				const auto dc = Mat2AdjMul(d, c);
+				const auto ab = Mat2AdjMul(a, b);
+				auto x = Sub(Mul(detD, a), Mat2Mul(b, dc));
+				auto w = Sub(Mul(detA, d), Mat2Mul(c, ab));
+				auto y = Sub(Mul(detB, c), Mat2MulAdj(d, ab));
+				auto z = Sub(Mul(detC, b), Mat2MulAdj(a, dc));
+
+				// |M| = |A||D| + |B||C| - tr(adj(A) B adj(D) C)
+				const auto det = GetX(detA) * GetX(detD) +
+								 GetX(detB) * GetX(detC) -
+								 Dot4(ab, Permute<0, 2, 1, 3>(dc));
+				const auto sign = Set(1.0f, -1.0f, -1.0f, 1.0f);
+				const auto scale = Div(sign, Splat(det));
+				x = Mul(x, scale);
+				y = Mul(y, scale);
+				z = Mul(z, scale);
+				w = Mul(w, scale);
+
+				Store(out + 0, Shuffle<3, 1, 3, 1>(x, y));
+				Store(out + 4, Shuffle<2, 0, 2, 0>(x, y));
+				Store(out + 8, Shuffle<3, 1, 3, 1>(z, w));
+				Store(out + 12, Shuffle<2, 0, 2, 0>(z, w));
+				return det;
+			}
+		}; // namespace Simd
+	}; // namespace Math
+};	   // namespace oxygen
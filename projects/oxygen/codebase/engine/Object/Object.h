@@ -7,17 +7,19 @@ namespace oxygen
 	{
 		const ObjectDescription* m_parent{};
 		std::string_view m_name{};
-		oxyU64 m_id{};
+		StringID m_id{};
 		oxySize m_size{};
 		oxySize m_align{};
 		using constructor_t = Object* (*)(void* p);
 		constructor_t m_constructor{};
 	};
 
-	inline auto GetObjectDescriptionMap()
-		-> std::unordered_map<oxyU64, const ObjectDescription*>&
+	using ObjectDescriptionMap =
+		std::unordered_map<StringID, const ObjectDescription*, Hasher>;
+
+	inline auto GetObjectDescriptionMap() -> ObjectDescriptionMap&
 	{
-		static std::unordered_map<oxyU64, const ObjectDescription*> map{};
+		static ObjectDescriptionMap map{};
 		return map;
 	}
 
@@ -47,8 +49,7 @@ namespace oxygen
 			static ObjectDescription desc{                                     \
 				.m_parent = &Parent::GetStaticDescription(),                   \
 				.m_name = #Name,                                               \
-				.m_id = CRC64Eval(reinterpret_cast<const oxyU8*>(#Name),       \
-								  sizeof(#Name) - 1),                          \
+				.m_id = ::oxygen::operator""_sid<#Name>(),                     \
 				.m_size = sizeof(Name),                                        \
 				.m_align = alignof(Name),                                      \
 				.m_constructor =                                               \
@@ -120,8 +121,7 @@ namespace oxygen
 				static ObjectDescription desc{
 					.m_parent = nullptr,
 					.m_name = "Object",
-					.m_id = CRC64Eval(reinterpret_cast<const oxyU8*>("Object"),
-									  sizeof("Object") - 1),
+					.m_id = "Object"_sid,
 					.m_size = sizeof(Object),
 					.m_align = alignof(Object),
 					.m_constructor = [](void* p) { return ::new (p) Object{}; },
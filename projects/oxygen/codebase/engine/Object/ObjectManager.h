@@ -36,11 +36,11 @@ namespace oxygen
 
 	  private:
 		oxyObjectID m_nextDynamicID{0x40000001};
-		std::unordered_map<oxyObjectID, Object*> m_objects{};
-		std::unordered_map<Object*, oxyObjectID> m_objectIDs{};
+		std::unordered_map<oxyObjectID, Object*, Hasher> m_objects{};
+		std::unordered_map<Object*, oxyObjectID, Hasher> m_objectIDs{};
 
 		oxyObjectID m_nextManagedID{0x80000001};
-		std::unordered_map<oxyObjectID, std::weak_ptr<ManagedObject>>
+		std::unordered_map<oxyObjectID, std::weak_ptr<ManagedObject>, Hasher>
 			m_managedObjects{};
 		struct ManagedObjectDeleter
 		{
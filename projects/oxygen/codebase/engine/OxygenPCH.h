@@ -9,6 +9,7 @@
 
 // util
 #include <utility>
+#include <bit>
 
 // execution
 #include <execution>
@@ -88,6 +89,8 @@
 // Engine headers
 #include "OxygenTypes.h"
 #include "Hash/CRC64.h"
+#include "Hash/StringID.h"
+#include "Hash/Hash.h"
 #include "Object/Object.h"
 #include "Object/ManagedObject.h"
 #include "Object/ObjectManager.h"
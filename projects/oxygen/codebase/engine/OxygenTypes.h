@@ -85,6 +85,7 @@ namespace oxygen
 		EventType_ControllerConnectionStateChangedEvent,
 		EventType_ControllerAxisValueChangedEvent,
 		EventType_ControllerButtonStateChangedEvent,
+		EventType_InputActionStateChangedEvent,
 
 		EventType_SceneChangedEvent,
 
@@ -303,6 +304,31 @@ namespace oxygen
 #define OXYGENMINTRIGGERVALUE 0.0f
 #define OXYGENMAXTRIGGERVALUE 1.0f
 
+	/**
+	 * @brief Packed button states, one bit per button. Word storage is 16 byte
+	 * aligned so change detection can XOR two words at a time.
+	 * @tparam BitCount The number of buttons.
+	 */
+	template <oxySize BitCount> struct InputBitset
+	{
+		static inline constexpr oxySize k_wordCount{(BitCount + 63) / 64};
+
+		alignas(16) oxyU64 m_words[k_wordCount]{};
+
+		auto Test(oxySize index) const -> oxyBool
+		{
+			return (m_words[index / 64] >> (index % 64)) & 1;
+		}
+		auto Set(oxySize index, oxyBool value) -> void
+		{
+			const auto mask = oxyU64{1} << (index % 64);
+			if (value)
+				m_words[index / 64] |= mask;
+			else
+				m_words[index / 64] &= ~mask;
+		}
+	};
+
 	/**
 	 * @brief Controller state.
 	 */
@@ -310,7 +336,9 @@ namespace oxygen
 	{
 		oxyBool m_connected{};
 		oxyF32 m_axisValues[ControllerAxis_Count]{};
-		oxyU8 m_buttonValues[ControllerButton_Count]{};
+		InputBitset<ControllerButton_Count> m_buttonValues{};
+		// GetHighPrecisionTime() of the latest change, zero if unknown
+		oxyU64 m_captureTime{};
 	};
 
 	/**
@@ -320,7 +348,9 @@ namespace oxygen
 	{
 		oxyF32 m_x{};
 		oxyF32 m_y{};
-		oxyU8 m_buttons[MouseButton_Count]{};
+		InputBitset<MouseButton_Count> m_buttons{};
+		// GetHighPrecisionTime() of the latest change, zero if unknown
+		oxyU64 m_captureTime{};
 	};
 
 	/**
@@ -328,7 +358,9 @@ namespace oxygen
 	 */
 	struct KeyboardInputState
 	{
-		oxyU8 m_keys[KeyboardButton_Count]{};
+		InputBitset<KeyboardButton_Count> m_keys{};
+		// GetHighPrecisionTime() of the latest change, zero if unknown
+		oxyU64 m_captureTime{};
 	};
 
 	/**
@@ -0,0 +1,91 @@
+#include "OxygenPCH.h"
+#include "Platform/CpuFeatures.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) ||             \
+	defined(__i386__)
+#define OXYCPUX86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace oxygen
+{
+	namespace
+	{
+#ifdef OXYCPUX86
+		struct CpuidResult
+		{
+			oxyU32 m_eax, m_ebx, m_ecx, m_edx;
+		};
+
+		auto Cpuid(oxyU32 leaf, oxyU32 subleaf) -> CpuidResult
+		{
+			CpuidResult result{};
+#ifdef _MSC_VER
+			int regs[4]{};
+			__cpuidex(regs, static_cast<int>(leaf), static_cast<int>(subleaf));
+			result.m_eax = static_cast<oxyU32>(regs[0]);
+			result.m_ebx = static_cast<oxyU32>(regs[1]);
+			result.m_ecx = static_cast<oxyU32>(regs[2]);
+			result.m_edx = static_cast<oxyU32>(regs[3]);
+#else
+			__cpuid_count(leaf, subleaf, result.m_eax, result.m_ebx,
+						  result.m_ecx, result.m_edx);
+#endif
+			return result;
+		}
+
+		/**
+		 * @brief XCR0, the register state the OS saves on context switches.
+		 */
+		auto ReadXcr0() -> oxyU64
+		{
+#ifdef _MSC_VER
+			return _xgetbv(0);
+#else
+			oxyU32 eax{}, edx{};
+			__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return (static_cast<oxyU64>(edx) << 32) | eax;
+#endif
+		}
+#endif
+
+		auto Detect() -> CpuFeatures
+		{
+			CpuFeatures features{};
+#ifdef OXYCPUX86
+			const auto maxLeaf = Cpuid(0, 0).m_eax;
+			if (maxLeaf < 1)
+				return features;
+			const auto leaf1 = Cpuid(1, 0);
+			features.m_sse41 = (leaf1.m_ecx >> 19) & 1;
+			features.m_pclmul = (leaf1.m_ecx >> 1) & 1;
+
+			// AVX state (XMM and YMM) must be enabled by the OS as well
+			const oxyBool osxsave = (leaf1.m_ecx >> 27) & 1;
+			const oxyBool avxState = osxsave && (ReadXcr0() & 0x6) == 0x6;
+			features.m_avx = avxState && ((leaf1.m_ecx >> 28) & 1);
+			features.m_fma = features.m_avx && ((leaf1.m_ecx >> 12) & 1);
+			features.m_f16c = features.m_avx && ((leaf1.m_ecx >> 29) & 1);
+			if (maxLeaf >= 7)
+			{
+				const auto leaf7 = Cpuid(7, 0);
+				features.m_avx2 = features.m_avx && ((leaf7.m_ebx >> 5) & 1);
+			}
+#elif defined(__aarch64__) || defined(_M_ARM64)
+			// Advanced SIMD is mandatory on AArch64
+			features.m_neon = true;
+#endif
+			return features;
+		}
+	}; // namespace
+
+	auto GetCpuFeatures() -> const CpuFeatures&
+	{
+		static const CpuFeatures features = Detect();
+		return features;
+	}
+}; // namespace oxygen
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace oxygen
+{
+	/**
+	 * @brief Instruction set extensions usable on the running machine. A flag
+	 * is only set when both the CPU and the operating system support it, so
+	 * kernels may be selected from it directly.
+	 */
+	struct CpuFeatures
+	{
+		oxyBool m_sse41 : 1 {};
+		oxyBool m_avx : 1 {};
+		oxyBool m_avx2 : 1 {};
+		oxyBool m_fma : 1 {};
+		oxyBool m_f16c : 1 {};
+		oxyBool m_pclmul : 1 {};
+		oxyBool m_neon : 1 {};
+	};
+
+	/**
+	 * @brief Detected once on first use.
+	 * @return Features of the running CPU
+	 */
+	auto GetCpuFeatures() -> const CpuFeatures&;
+}; // namespace oxygen
@@ -0,0 +1,162 @@
+#include "OxygenPCH.h"
+#include "Platform/Platform.h"
+
+#include "Events/EventManager.h"
+#include "Events/EventSelfCheck.h"
+#include "Filesystem/Filesystem.h"
+#include "Input/HeadlessInputSource.h"
+#include "Input/InputManager.h"
+#include "Math/Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+	/**
+	 * @brief The singletons the input path needs, without the renderer and
+	 * the game, so these modes also run where there is no graphics API.
+	 */
+	struct InternalHeadlessSingletonsOrder
+	{
+		oxygen::SingletonInstance<oxygen::Filesystem> m_filesystem{};
+		oxygen::SingletonInstance<oxygen::EventManager> m_eventManager{};
+		oxygen::SingletonInstance<oxygen::InputManager> m_inputManager{};
+	};
+	using HeadlessSingletons =
+		oxygen::SingletonHolder<InternalHeadlessSingletonsOrder>;
+
+	/**
+	 * @brief Runs frames like the windowed main loop until the source runs
+	 * out or maxFrames have passed, then prints the latency of every frame.
+	 */
+	auto RunHeadlessInput(oxygen::HeadlessInputSource& source,
+						  oxyU64 maxFrames) -> int
+	{
+		using namespace oxygen;
+		auto& im = InputManager::GetInstance();
+		auto& em = EventManager::GetInstance();
+		auto& tracker = im.GetLatencyTracker();
+		tracker.SetEnabled(true);
+
+		auto lastTime = GetHighPrecisionTime();
+		auto hasInput = true;
+		while (hasInput && source.GetFrame() < maxFrames)
+		{
+			const auto now = GetHighPrecisionTime();
+			const auto dt = HighPrecisionTimeToSeconds(now - lastTime);
+			lastTime = now;
+			im.BeginUpdate(static_cast<oxyF32>(dt));
+			hasInput = source.Update(im);
+			im.EndUpdate();
+			em.ProcessEvents();
+			tracker.EndFrame();
+		}
+
+		const auto csv = tracker.DumpCSV();
+		std::fwrite(csv.data(), 1, csv.size(), stdout);
+		std::fprintf(stderr,
+					 "%llu frames, dispatch p50 %.3fms p99 %.3fms, present "
+					 "p99 %.3fms\n",
+					 static_cast<unsigned long long>(source.GetFrame()),
+					 HighPrecisionTimeToSeconds(
+						 tracker.GetDispatchPercentile(50.0f)) * 1e3,
+					 HighPrecisionTimeToSeconds(
+						 tracker.GetDispatchPercentile(99.0f)) * 1e3,
+					 HighPrecisionTimeToSeconds(
+						 tracker.GetPresentPercentile(99.0f)) * 1e3);
+		tracker.SetEnabled(false);
+		return 0;
+	}
+}; // namespace
+
+namespace oxygen
+{
+	auto RunHeadlessMode(int argc, char* argv[], int& exitCode) -> oxyBool
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string_view arg{argv[i]};
+			if (arg == "--math-benchmark")
+			{
+				const auto results = Math::RunBenchmarks();
+				const auto csv = Math::DumpBenchmarkCSV(results);
+				std::fwrite(csv.data(), 1, csv.size(), stdout);
+				exitCode = 0;
+				for (const auto& result : results)
+				{
+					if (result.IsWithinTolerance())
+						continue;
+					std::fprintf(stderr, "%.*s (%s): error %.3e above %.3e\n",
+								 static_cast<int>(result.m_name.size()),
+								 result.m_name.data(),
+								 result.m_backend.c_str(),
+								 result.m_maxRelativeError,
+								 result.m_tolerance);
+					exitCode = 1;
+				}
+				return true;
+			}
+			if (arg == "--math-determinism")
+			{
+				const auto hash = Math::RunDeterminismHash();
+				const auto csv = Math::DumpDeterminismHashCSV(hash);
+				std::fwrite(csv.data(), 1, csv.size(), stdout);
+				exitCode = 0;
+#ifdef OXYMATHDETERMINISTIC
+				// Other builds may differ per CPU, there is nothing to
+				// compare them against
+				if (hash != Math::k_deterministicHash)
+				{
+					const auto& expected = Math::k_deterministicHash;
+					std::fprintf(
+						stderr,
+						"Math determinism hash differs, expected "
+						"%016llx,%016llx,%016llx\n",
+						static_cast<unsigned long long>(expected.m_trig),
+						static_cast<unsigned long long>(expected.m_inverseTrig),
+						static_cast<unsigned long long>(expected.m_composite));
+					exitCode = 1;
+				}
+#endif
+				return true;
+			}
+			if (arg == "--event-selfcheck")
+			{
+				HeadlessSingletons::Construct();
+				const auto failed = RunEventSelfCheck();
+				HeadlessSingletons::Destruct();
+				for (const auto name : failed)
+					std::fprintf(stderr, "Event self check %.*s failed\n",
+								 static_cast<int>(name.size()), name.data());
+				exitCode = failed.empty() ? 0 : 1;
+				return true;
+			}
+			const auto isScript = arg == "--headless-input" && i + 1 < argc;
+			const auto isRandom = arg == "--headless-random" && i + 2 < argc;
+			if (!isScript && !isRandom)
+				continue;
+
+			HeadlessSingletons::Construct();
+			HeadlessInputSource source{};
+			auto maxFrames = std::numeric_limits<oxyU64>::max();
+			if (isRandom)
+			{
+				source.SetRandom(std::strtoull(argv[i + 1], nullptr, 0));
+				maxFrames = std::strtoull(argv[i + 2], nullptr, 0);
+				exitCode = RunHeadlessInput(source, maxFrames);
+			}
+			else if (source.LoadScriptFile(argv[i + 1]))
+				exitCode = RunHeadlessInput(source, maxFrames);
+			else
+			{
+				std::fprintf(stderr, "Could not load input script %s\n",
+							 argv[i + 1]);
+				exitCode = 1;
+			}
+			HeadlessSingletons::Destruct();
+			return true;
+		}
+		return false;
+	}
+}; // namespace oxygen
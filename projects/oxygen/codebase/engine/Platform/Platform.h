@@ -10,6 +10,27 @@ namespace oxygen
 	*/
 	auto Main(int argc, char* argv[]) -> int;
 
+	/**
+	 * @brief Runs the modes that need no window or renderer, shared by the
+	 * Main of every platform:
+	 *   --math-benchmark                   Math::RunBenchmarks as CSV,
+	 *                                      fails if a row is above its
+	 *                                      tolerance
+	 *   --math-determinism                 Math::RunDeterminismHash as CSV,
+	 *                                      fails on a mismatch with
+	 *                                      Math::k_deterministicHash in
+	 *                                      OXYMATHDETERMINISTIC builds
+	 *   --event-selfcheck                  RunEventSelfCheck, fails and
+	 *                                      names the failed checks
+	 *   --headless-input <script>          HeadlessInputSource script
+	 *   --headless-random <seed> <frames>  HeadlessInputSource::SetRandom
+	 * The input modes pump InputManager and EventManager every frame and
+	 * print InputLatencyTracker::DumpCSV to stdout.
+	 * @param exitCode Set when a mode ran
+	 * @return False if the arguments select none of these modes
+	 */
+	auto RunHeadlessMode(int argc, char* argv[], int& exitCode) -> oxyBool;
+
 	/**
 	 * @brief Get the current platform-defined high resolution time
 	 * @return Current time
@@ -0,0 +1,66 @@
+#include "OxygenPCH.h"
+#ifndef OXYWIN32
+#include "Platform/Platform.h"
+
+#include <cstdio>
+#include <ctime>
+
+namespace
+{
+	auto g_exeDirectory = std::string{};
+}; // namespace
+
+namespace oxygen
+{
+	/**
+	 * @brief No window or renderer exists on this platform yet, only the
+	 * headless modes run.
+	 */
+	auto Main(int argc, char* argv[]) -> int
+	{
+		if (argc > 0)
+		{
+			g_exeDirectory = argv[0];
+			const auto slash = g_exeDirectory.find_last_of('/');
+			g_exeDirectory = slash == std::string::npos
+								 ? std::string{"."}
+								 : g_exeDirectory.substr(0, slash);
+		}
+
+		int exitCode{};
+		if (RunHeadlessMode(argc, argv, exitCode))
+			return exitCode;
+		std::fprintf(stderr,
+					 "Usage: %s --math-benchmark | --math-determinism | "
+					 "--event-selfcheck | --headless-input <script> | "
+					 "--headless-random <seed> <frames>\n",
+					 argc > 0 ? argv[0] : "oxygen");
+		return 1;
+	}
+
+	auto GetHighPrecisionTime() -> oxyU64
+	{
+		timespec time{};
+		clock_gettime(CLOCK_MONOTONIC, &time);
+		return static_cast<oxyU64>(time.tv_sec) * 1000000000ULL +
+			   static_cast<oxyU64>(time.tv_nsec);
+	}
+	auto HighPrecisionTimeToSeconds(oxyU64 time) -> oxyF64
+	{
+		return time / 1000000000.0;
+	}
+	auto GetApplicationDirectory() -> std::string_view
+	{
+		return g_exeDirectory;
+	}
+	auto GetPlatformWindow() -> void*
+	{
+		return nullptr;
+	}
+	auto GetRenderContext() -> IRenderContext*
+	{
+		return nullptr;
+	}
+}; // namespace oxygen
+
+#endif
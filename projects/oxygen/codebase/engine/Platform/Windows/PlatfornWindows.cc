@@ -28,11 +28,11 @@ namespace
 #define TESTKEYBTN(bridgeEnum, winKey)                                         \
 	if (wParam == winKey && msg == WM_KEYDOWN)                                 \
 	{                                                                          \
-		g_keyboard.m_keys[oxygen::bridgeEnum] = true;                          \
+		g_keyboard.m_keys.Set(oxygen::bridgeEnum, true);                       \
 	}                                                                          \
 	else if (wParam == winKey && msg == WM_KEYUP)                              \
 	{                                                                          \
-		g_keyboard.m_keys[oxygen::bridgeEnum] = false;                         \
+		g_keyboard.m_keys.Set(oxygen::bridgeEnum, false);                      \
 	}
 		TESTKEYBTN(KeyboardButton_A, 'A');
 		TESTKEYBTN(KeyboardButton_B, 'B');
@@ -151,6 +151,8 @@ namespace
 		TESTKEYBTN(KeyboardButton_Hyphen, VK_OEM_MINUS);
 		TESTKEYBTN(KeyboardButton_Equals, VK_OEM_PLUS);
 #undef TESTKEYBTN
+		if (msg == WM_KEYDOWN || msg == WM_KEYUP)
+			g_keyboard.m_captureTime = oxygen::GetHighPrecisionTime();
 
 		switch (msg)
 		{
@@ -291,6 +293,11 @@ namespace oxygen
 			g_exeDirectory.substr(0, g_exeDirectory.find_last_of('\\'));
 		std::replace(g_exeDirectory.begin(), g_exeDirectory.end(), '\\', '/');
 
+		// Benchmarks and scripted input runs need no window
+		int exitCode{};
+		if (RunHeadlessMode(argc, argv, exitCode))
+			return exitCode;
+
 		if (!OxygenCreateWindow())
 			return 1;
 
@@ -314,6 +321,9 @@ namespace oxygen
 			im.UpdateKeyboard(g_keyboard);
 			im.UpdateMouse(g_mouse);
 			im.EndUpdate();
+			// Dispatch this frame's input before the world reads it, the
+			// latency tracker's listeners stamp the samples here
+			EventManager::GetInstance().ProcessEvents();
 
 			if (g_renderContext)
 			{
@@ -323,6 +333,7 @@ namespace oxygen
 
 				g_renderContext->EndFrame();
 			}
+			im.GetLatencyTracker().EndFrame();
 		}
 		g_inWindowLoop = false;
 